@@ -1,7 +1,9 @@
 ////////////////////////////////
-/// usage : 1.	generate html with svg graph.
-/// 
-/// note  : 1.	
+/// usage : 1.	generate html with svg graph, or a ppm image if the path ends with ".ppm".
+///
+/// note  : 1.	the whole document is buffered in memory and written to the file at end().
+///         2.	labels and borders of the items which are too small on the canvas are culled.
+///         3.	the image is an occupancy raster of the items where overlapped pixels are red.
 ////////////////////////////////
 
 #ifndef SMART_SZX_GATE_ASSIGNMENT_VISUALIZER_H
@@ -10,10 +12,12 @@
 
 #include <algorithm>
 #include <string>
+#include <sstream>
 #include <iostream>
 #include <fstream>
+#include <vector>
 
-#include <cstdlib>
+#include <cmath>
 
 
 namespace szx {
@@ -23,16 +27,27 @@ struct RandColor {
     static constexpr int ColorCodeBase = 16;
     static constexpr int ColorCodeLen = 6;
 
+    // xorshift instead of rand() so that the colors are the same in every run.
     void next() {
         for (int i = 0; i < ColorCodeLen; ++i) {
-            int c = rand() % ColorCodeBase;
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            int c = static_cast<int>((state >> 8) % ColorCodeBase);
             bcolor[i] = ColorCodeChar[c];
             fcolor[i] = ColorCodeChar[(c >(ColorCodeBase / 2)) ? 0 : (ColorCodeBase - 1)]; // (c + ColorCodeBase / 2) % ColorCodeBase
         }
     }
 
+    // the red, green or blue component of the background color.
+    unsigned char channel(int rgb) const {
+        auto digit = [](char c) { return (c <= '9') ? (c - '0') : (c - 'A' + 10); };
+        return static_cast<unsigned char>(digit(bcolor[2 * rgb]) * ColorCodeBase + digit(bcolor[2 * rgb + 1]));
+    }
+
     char fcolor[ColorCodeLen + 1] = { 0 }; // front color.
     char bcolor[ColorCodeLen + 1] = { 0 }; // background color.
+    unsigned state = 2463534242u;
 };
 
 struct Drawer {
@@ -70,60 +85,136 @@ struct Drawer {
     static constexpr double CanvasHeight = 960 * Scale;
     static constexpr int FontSize = static_cast<int>(12 * Scale);
 
+    static constexpr double LabelCharWidth = 0.6 * FontSize; // approximate width of a digit.
+    static constexpr double MinStrokedSize = 8 * Scale; // items narrower than this are drawn without borders.
+
+    static std::string RasterExtension() { return ".ppm"; }
+
 
     void begin(std::string path, double plateWidth, double plateHeight, double plateNum, double plateGap) {
         wx = CanvasWidth / plateWidth;
         hx = CanvasHeight / plateHeight;
         int width = static_cast<int>(wx * plateWidth + 1);
         int height = static_cast<int>(hx * (plateHeight * plateNum + plateGap * (plateNum - 1)) + 1);
-        ofs.open(path);
-        ofs << "<!DOCTYPE html>" << std::endl
-            << "<html>" << std::endl
-            << "  <head>" << std::endl
-            << "    <meta charset='utf-8'>" << std::endl
-            << "    <title>2D Packing/Cutting Visualization</title>" << std::endl
-            << "  </head>" << std::endl
-            << "  <body>" << std::endl // style='text-align:center;'
-            << "    <svg width='" << width << "' height='" << height << "' viewBox='0 0 " << width << " " << height << "'>" << std::endl;
+        filePath = path;
+        isRaster = (path.size() >= RasterExtension().size())
+            && (path.compare(path.size() - RasterExtension().size(), RasterExtension().size(), RasterExtension()) == 0);
+        if (isRaster) {
+            rasterWidth = width;
+            rasterHeight = height;
+            occupancy.assign(static_cast<size_t>(width) * height, 0);
+            pixels.assign(3 * occupancy.size(), 0xFF);
+            return;
+        }
+        ofs.str("");
+        ofs << "<!DOCTYPE html>\n"
+            << "<html>\n"
+            << "  <head>\n"
+            << "    <meta charset='utf-8'>\n"
+            << "    <title>2D Packing/Cutting Visualization</title>\n"
+            << "  </head>\n"
+            << "  <body>\n" // style='text-align:center;'
+            << "    <svg width='" << width << "' height='" << height << "' viewBox='0 0 " << width << " " << height << "'>\n";
     }
-    void end() {
-        ofs << "    </svg>" << std::endl
-            << "  </body>" << std::endl
-            << "</html>" << std::endl;
-        ofs.close();
+    // return false if the file can not be written.
+    bool end() {
+        std::ofstream file(filePath, std::ios::binary);
+        if (!file.is_open()) { return false; }
+        if (isRaster) {
+            file << "P6\n" << rasterWidth << " " << rasterHeight << "\n255\n";
+            file.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+            return true;
+        }
+        ofs << "    </svg>\n"
+            << "  </body>\n"
+            << "</html>\n";
+        file << ofs.str();
+        return true;
     }
 
     void rect(double x, double y, double w, double h, bool d, const std::string &label, const std::string &fcolor, const std::string &bcolor) {
         if (d) { std::swap(w, h); }
         x *= wx; y *= hx; w *= wx; h *= hx;
-        ofs << "      <rect x='" << x << "' y='" << y << "' width='" << w << "' height='" << h << "' style='fill:#" << bcolor << "; stroke:black; stroke-width:2'/>" << std::endl
-            << "      <text x='" << x + w / 2 << "' y='" << y + h / 2 << "' text-anchor='middle' alignment-baseline='middle' style='fill:#" << fcolor << ";font-size:" << FontSize << "'>" << label << "</text>" << std::endl << std::endl;
+        int strokeWidth = ((std::min)(w, h) < MinStrokedSize) ? 0 : 2;
+        ofs << "      <rect x='" << x << "' y='" << y << "' width='" << w << "' height='" << h << "' style='fill:#" << bcolor << "; stroke:black; stroke-width:" << strokeWidth << "'/>\n";
+        if ((w < LabelCharWidth * label.size()) || (h < FontSize)) { return; } // the label would not fit in.
+        ofs << "      <text x='" << x + w / 2 << "' y='" << y + h / 2 << "' text-anchor='middle' alignment-baseline='middle' style='fill:#" << fcolor << ";font-size:" << FontSize << "'>" << label << "</text>\n";
     }
     void rect(double x, double y, double w, double h, bool d, const std::string &label) {
         rc.next();
+        if (isRaster) {
+            if (d) { std::swap(w, h); }
+            fill(x * wx, y * hx, w * wx, h * hx);
+            return;
+        }
         rect(x, y, w, h, d, label, rc.fcolor, rc.bcolor);
     }
     void rect(double x, double y, double w, double h) {
+        if (isRaster) { return; }
         x *= wx; y *= hx; w *= wx; h *= hx;
-        ofs << "      <rect x='" << x << "' y='" << y << "' width='" << w << "' height='" << h << "' style='fill:#FFFFFF; stroke:black; stroke-width:12'/>" << std::endl << std::endl;
+        ofs << "      <rect x='" << x << "' y='" << y << "' width='" << w << "' height='" << h << "' style='fill:#FFFFFF; stroke:black; stroke-width:12'/>\n";
     }
 
     void line(double x1, double y1, double x2, double y2, int layer) {
         static int cutWidth[] = { 10, 8, 8, 6 };
         static std::string cutColor[] = { "cyan", "red", "blue", "orange" };
+        if (isRaster) { return; }
         x1 *= wx; y1 *= hx; x2 *= wx; y2 *= hx;
-        ofs << "      <line x1='" << x1 << "' y1='" << y1 << "' x2='" << x2 << "' y2='" << y2 << "' stroke-dasharray='12, 4' stroke='" << cutColor[layer] << "' stroke-width='" << cutWidth[layer] << "'/>" << std::endl << std::endl;
+        ofs << "      <line x1='" << x1 << "' y1='" << y1 << "' x2='" << x2 << "' y2='" << y2 << "' stroke-dasharray='12, 4' stroke='" << cutColor[layer] << "' stroke-width='" << cutWidth[layer] << "'/>\n";
     }
 
     void circle(double x, double y, double r) {
-        ofs << "      <circle cx='" << x << "' cy='" << y << "' r='" << r << "' style='fill-opacity:0; stroke:#000000; stroke-width:2'/>" << std::endl;
+        if (isRaster) { return; }
+        ofs << "      <circle cx='" << x << "' cy='" << y << "' r='" << r << "' style='fill-opacity:0; stroke:#000000; stroke-width:2'/>\n";
     }
 
+protected:
+    // paint the pixels covered by the item. every item covers at least one pixel so that it is never lost,
+    // but only the pixels inside its rounded bounds are counted for overlaps, or items smaller than
+    // a pixel would look overlapped with the neighbors they merely touch.
+    void fill(double x, double y, double w, double h) {
+        int x0 = static_cast<int>(std::lround(x)), y0 = static_cast<int>(std::lround(y));
+        int x1 = static_cast<int>(std::lround(x + w)), y1 = static_cast<int>(std::lround(y + h));
+        bool isCounted = (x1 > x0) && (y1 > y0);
+        x1 = (std::max)(x1, x0 + 1); x1 = (std::min)(x1, rasterWidth);
+        y1 = (std::max)(y1, y0 + 1); y1 = (std::min)(y1, rasterHeight);
+        x0 = (std::max)(x0, 0);
+        y0 = (std::max)(y0, 0);
+        for (int i = y0; i < y1; ++i) {
+            for (int j = x0; j < x1; ++j) {
+                size_t p = static_cast<size_t>(i) * rasterWidth + j;
+                if (!isCounted) { // keep the red of real overlaps.
+                    if (occupancy[p] <= 1) { paint(p, rc.channel(0), rc.channel(1), rc.channel(2)); }
+                    continue;
+                }
+                bool isOverlapped = (occupancy[p] > 0);
+                if (occupancy[p] < 0xFF) { ++occupancy[p]; }
+                if (isOverlapped) {
+                    paint(p, 0xFF, 0, 0);
+                } else {
+                    paint(p, rc.channel(0), rc.channel(1), rc.channel(2));
+                }
+            }
+        }
+    }
+    void paint(size_t p, unsigned char r, unsigned char g, unsigned char b) {
+        pixels[3 * p] = r;
+        pixels[3 * p + 1] = g;
+        pixels[3 * p + 2] = b;
+    }
 
+public:
     double wx; // width expansion.
     double hx; // height expansion.
-    std::ofstream ofs;
+    std::ostringstream ofs; // the html document.
     RandColor rc;
+
+    std::string filePath;
+    bool isRaster = false;
+    int rasterWidth = 0;
+    int rasterHeight = 0;
+    std::vector<unsigned char> occupancy; // number of items covering each pixel.
+    std::vector<unsigned char> pixels; // rgb of each pixel.
 };
 
 
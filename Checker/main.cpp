@@ -2,10 +2,19 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <thread>
 
 #include "Visualizer.h"
 
 #include "../Solver/PbReader.h"
+#include "../Solver/SolutionChecker.h"
+#include "../Solver/CsvReader.h"
+#include "../Solver/ThreadPool.h"
 #include "../Solver/RectPacking.pb.h"
 
 
@@ -13,13 +22,90 @@ using namespace std;
 //using namespace ck;
 using namespace pb;
 
-int main(int argc, char *argv[]) {
-    enum CheckerFlag {
-        IoError = 0x0,
-        FormatError = 0x1,
-		CoordinateOverError = 0x2,
-        RectangleOverlapError = 0x4,
+using CheckerFlag = ck::SolutionChecker::CheckerFlag;
+
+// load and check a pair of files, the return code is the same as the checker program.
+int check(const string &inputPath, const string &outputPath, pb::RectPacking::Input &input, pb::RectPacking::Output &output) {
+    if (!load(inputPath, input)) { return ~CheckerFlag::IoError; }
+
+    ck::MappedFile solution(outputPath);
+    if (!solution.isOpen()) { return ~CheckerFlag::IoError; }
+
+    int error = 0;
+    if (!parseWithHeader(solution.data(), solution.size(), output)) { error |= CheckerFlag::FormatError; } // skip the submission line in json.
+    return ck::SolutionChecker::check(input, output, error);
+}
+
+// check the pairs of instance and solution paths listed in the manifest (separated by ';') on a thread pool.
+// each pair is loaded and checked by one job so that parsing overlaps checking.
+// the results are written as csv in the order of the manifest once they are ready.
+// return the number of pairs which are not feasible.
+int checkBatch(const string &manifestPath, ostream &os, int threadNum) {
+    struct Result {
+        int returnCode;
+        string row;
     };
+
+    ck::CsvReader reader;
+    const vector<ck::CsvReader::Row> &pairs(reader.scan(manifestPath));
+
+    ck::ThreadPool<> pool(threadNum);
+    vector<future<Result>> results;
+    results.reserve(pairs.size());
+    for (auto p = pairs.begin(); p != pairs.end(); ++p) {
+        if (p->size() < 2) { continue; }
+        string inputPath((*p)[0]);
+        string outputPath((*p)[1]);
+        results.push_back(pool.submit([inputPath, outputPath]() {
+            auto begin = chrono::steady_clock::now();
+            pb::RectPacking::Input input;
+            pb::RectPacking::Output output;
+            int returnCode = check(inputPath, outputPath, input, output);
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+
+            ostringstream oss;
+            oss << inputPath << "," << outputPath << "," << (returnCode > 0) << "," << output.length() << ","
+                << ((returnCode > 0) ? 0 : ~returnCode) << "," << ms << "\n";
+            return Result{ returnCode, oss.str() };
+        }));
+    }
+
+    int infeasibleNum = 0;
+    os << "Instance,Solution,Feasible,Length,Flags,Milliseconds\n";
+    for (auto r = results.begin(); r != results.end(); ++r) {
+        Result result(r->get());
+        if (result.returnCode <= 0) { ++infeasibleNum; }
+        os << result.row;
+    }
+    os << flush;
+    return infeasibleNum;
+}
+
+int main(int argc, char *argv[]) {
+    // checker -batch manifestPath [resultPath] [-j threadNum]
+    // exit with 1 if any pair is infeasible, the details are in the csv.
+    if ((argc > 2) && (string(argv[1]) == "-batch")) {
+        string resultPath;
+        int threadNum = (max)(1, static_cast<int>(thread::hardware_concurrency()));
+        for (int i = 3; i < argc; ++i) {
+            if ((string(argv[i]) == "-j") && (i + 1 < argc)) {
+                threadNum = (max)(1, atoi(argv[++i]));
+            } else {
+                resultPath = argv[i];
+            }
+        }
+        int infeasibleNum;
+        if (resultPath.empty()) {
+            infeasibleNum = checkBatch(argv[2], cout, threadNum);
+        } else {
+            ofstream ofs(resultPath);
+            if (!ofs.is_open()) { return -1; }
+            infeasibleNum = checkBatch(argv[2], ofs, threadNum);
+        }
+        cerr << infeasibleNum << " infeasible." << endl;
+        return (infeasibleNum > 0) ? 1 : 0; // the count does not fit in the exit code which is truncated to 8 bits.
+    }
+
     string inputPath;
     string outputPath;
 
@@ -37,61 +123,42 @@ int main(int argc, char *argv[]) {
         cin >> outputPath;
     }
 
-    pb::RectPacking::Input input;
-    if (!load(inputPath, input)) { return ~CheckerFlag::IoError; }
-
-    pb::RectPacking::Output output;
-    ifstream ifs(outputPath);
-    if (!ifs.is_open()) { return ~CheckerFlag::IoError; }
-    string submission;
-    getline(ifs, submission); // skip the first line.
-    ostringstream oss;
-    oss << ifs.rdbuf();
-    jsonToProtobuf(oss.str(), output);
+    string visualizationPath; // draw the solution into html, or ppm if the path ends with ".ppm".
+    if ((argc > 4) && (string(argv[3]) == "-vis")) { visualizationPath = argv[4]; }
 
 	//check solution.
-	int error = 0;
+    pb::RectPacking::Input input;
+    pb::RectPacking::Output output;
+	int returnCode = check(inputPath, outputPath, input, output);
+    if (returnCode == ~CheckerFlag::IoError) { return returnCode; }
 	int bufferEdge = output.length();
-	int areaSum = 0;
-	if (output.placements().size() != input.rectangles().size()) { error |= CheckerFlag::FormatError; }
-	for (auto rect1 = output.placements().begin(); rect1 != output.placements().end(); ++rect1) {
-		//ÿǷ񳬹߽
-		
-		int width1 = input.rectangles(rect1->id()).width();
-		int height1 = input.rectangles(rect1->id()).height();
-		if (rect1->rotated()){
-		//ת򽻻ߺͿֵ
-			int t1 = width1; 
-			width1 = height1;
-			height1 = t1;
-		}
-		areaSum += width1 * height1;
-		int rect1_x = rect1->x(), rect1_y = rect1->y();
-		if (rect1_x > bufferEdge || rect1_y > bufferEdge || rect1_x < 0 || rect1_y < 0 ||
-			rect1_x + width1 > bufferEdge || rect1_y + height1 > bufferEdge) {
-			error |= CheckerFlag::CoordinateOverError;	
-			break;
-		}
-		//ÿ֮Ƿص
-		for (auto rect2 = rect1 + 1; rect2 != output.placements().end(); ++rect2) {
-			int rect2_id = rect2->id(), rect2_x = rect2->x(), rect2_y = rect2->y();
-			int width2 = input.rectangles(rect2_id).width();
-			int height2 = input.rectangles(rect2_id).height();
-			if (rect2->rotated()){
-				int t2 = width2;
-				width2 = height2;
-				height2 = t2;
-			}
-			if (rect1_x + width1 > rect2_x && rect1_x < rect2_x + width2 &&
-				rect1_y + height1 > rect2_y && rect1_y < rect2_y + height2 ) {
-				error |= CheckerFlag::RectangleOverlapError;
-				break;
-			}
-		}
-	}
+    if (!visualizationPath.empty()) { // overlaps are red in ppm.
+        // the canvas covers the items out of the claimed square too, so infeasible solutions are shown as they are.
+        long long lo = 0;
+        long long hi = bufferEdge;
+        for (auto p = output.placements().begin(); p != output.placements().end(); ++p) {
+            if ((p->id() < 0) || (p->id() >= input.rectangles().size())) { continue; }
+            const auto &r(input.rectangles(p->id()));
+            long long w = p->rotated() ? r.height() : r.width();
+            long long h = p->rotated() ? r.width() : r.height();
+            lo = (min)(lo, (min)(static_cast<long long>(p->x()), static_cast<long long>(p->y())));
+            hi = (max)(hi, (max)(p->x() + w, p->y() + h));
+        }
+        double side = static_cast<double>(hi - lo);
+        if (side > 0) {
+            szx::Drawer draw;
+            draw.begin(visualizationPath, side, side, 1, 0);
+            draw.rect(-lo, -lo, bufferEdge, bufferEdge);
+            for (auto p = output.placements().begin(); p != output.placements().end(); ++p) {
+                if ((p->id() < 0) || (p->id() >= input.rectangles().size())) { continue; }
+                const auto &r(input.rectangles(p->id()));
+                draw.rect(p->x() - lo, p->y() - lo, r.width(), r.height(), p->rotated(), to_string(p->id()));
+            }
+            if (!draw.end()) { cerr << "fail to write " << visualizationPath << endl; }
+        }
+    }
     //cout << "length: " << output.length() << endl;
     //cout << "error" << error << endl;
-	int returnCode = (error == 0) ? output.length() : ~error;
 	cout << returnCode << endl;
 	return returnCode;
 
@@ -6,11 +6,13 @@
 #include <vector>
 #include <algorithm>
 #include <random>
+#include <atomic>
+#include <chrono>
 
 #include <cstring>
 
 #include "Simulator.h"
-#include "ThreadPool.h"
+#include "../Solver/ThreadPool.h"
 
 
 using namespace std;
@@ -166,6 +168,27 @@ void Simulator::parallelBenchmark(int repeat) {
     }
 }
 
+template<typename ThreadPoolImpl>
+static double measureThreadPool(int jobNum, int threadNum) {
+    atomic<long long> sum(0);
+    auto begin = chrono::steady_clock::now();
+    {
+        ThreadPool<ThreadPoolImpl> tp(threadNum);
+        for (int i = 0; i < jobNum; ++i) { tp.push([&sum, i]() { sum += i; }); }
+    } // wait for all jobs to finish.
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    if (sum != static_cast<long long>(jobNum) * (jobNum - 1) / 2) { cout << "some jobs are lost!" << endl; }
+    return jobNum / seconds;
+}
+
+void Simulator::threadPoolBenchmark(int jobNum, int threadNum) {
+    cout << "jobs per second with " << threadNum << " threads:" << endl;
+    cout << "Queue      " << measureThreadPool<impl::ThreadPool::QueueImpl>(jobNum, threadNum) << endl;
+    cout << "SingleSlot " << measureThreadPool<impl::ThreadPool::SingleSlotImpl>(jobNum, threadNum) << endl;
+    cout << "LockFree   " << measureThreadPool<impl::ThreadPool::LockFreeQueueImpl>(jobNum, threadNum) << endl;
+    cout << "WorkSteal  " << measureThreadPool<impl::ThreadPool::WorkStealingImpl>(jobNum, threadNum) << endl;
+}
+
 void Simulator::generateInstance(const InstanceTrait &trait) {
 	Random rand;
 	int cuttingTimes = rand.pick(trait.cuttingTimes.begin, trait.cuttingTimes.end);
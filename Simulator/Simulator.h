@@ -82,6 +82,8 @@ public:
     void benchmark(int repeat = 1);
     // utility for testing all instances using a thread pool.
     void parallelBenchmark(int repeat);
+    // utility for comparing the throughput of thread pool implementations on tiny jobs.
+    void threadPoolBenchmark(int jobNum = (1 << 20), int threadNum = 4);
 
 
     void generateInstance(const InstanceTrait &trait);
@@ -0,0 +1,166 @@
+////////////////////////////////
+/// usage : 1.	decode a sequence of rectangles into a packing by bottom-left-fill.
+///
+/// note  : 1.	the candidate positions are the origin and the lower right and upper left
+///             corners of the placed rectangles. each rectangle takes the feasible candidate
+///             (in either orientation) which leads to the smallest bounding square, with ties
+///             broken by the less vacant area below it, the lower and then the lefter position.
+///         2.	the vacant area below a candidate is counted by a summed-area table, which is
+///             only maintained if the raster of the bounded square is small enough.
+///         3.	each worker (thread) should own its decoder since it holds the scratch space.
+////////////////////////////////
+
+#ifndef SMART_CK_RECT_PACKING_BOTTOM_LEFT_DECODER_H
+#define SMART_CK_RECT_PACKING_BOTTOM_LEFT_DECODER_H
+
+
+#include "Config.h"
+
+#include <algorithm>
+
+#include "Common.h"
+#include "BoundingSquare.h"
+#include "OverlapKernel.h"
+#include "SummedAreaTable.h"
+#include "RectPacking.pb.h"
+
+
+namespace ck {
+
+class BottomLeftDecoder {
+public:
+    static constexpr Length NoBound = (1 << 30);
+    static constexpr int MaxScoredRasterArea = (1 << 16);
+
+
+    BottomLeftDecoder(const pb::RectPacking::Input &input) : square(static_cast<ID>(input.rectangles().size())) {
+        ID rectNum = static_cast<ID>(input.rectangles().size());
+        widths.resize(rectNum);
+        heights.resize(rectNum);
+        totalLength = 0;
+        for (auto r = input.rectangles().begin(); r != input.rectangles().end(); ++r) {
+            widths[r->id()] = r->width();
+            heights[r->id()] = r->height();
+            totalLength += (std::max)(r->width(), r->height());
+        }
+        xs.resize(rectNum);
+        ys.resize(rectNum);
+        rotations.resize(rectNum);
+        placed.reserve(rectNum);
+        corners.reserve(2 * rectNum + 1);
+    }
+
+
+    // the rectangles sorted by decreasing area, which is a good sequence to start with.
+    List<ID> defaultOrder() const {
+        List<ID> order(widths.size());
+        for (ID r = 0; r < static_cast<ID>(order.size()); ++r) { order[r] = r; }
+        std::stable_sort(order.begin(), order.end(), [this](ID l, ID r) {
+            return (widths[l] * heights[l]) > (widths[r] * heights[r]);
+        });
+        return order;
+    }
+
+    // place the rectangles in the given order.
+    // return false once a rectangle can not be placed inside the square with side length bound.
+    bool decode(const List<ID> &order, Length bound = NoBound) {
+        placed.clear();
+        square.reset(static_cast<ID>(widths.size()));
+        corners.clear();
+        corners.push_back({ 0, 0 });
+
+        Length rasterSide = (std::min)(bound, totalLength); // no placement reaches beyond totalLength.
+        isScored = (static_cast<long long>(rasterSide) * rasterSide <= MaxScoredRasterArea);
+        if (isScored) { raster.reset(rasterSide, rasterSide); }
+
+        for (auto r = order.begin(); r != order.end(); ++r) {
+            if (isScored) { raster.commit(); }
+            Candidate best = { 0, 0, false, NoBound, 0 };
+            evaluate(*r, widths[*r], heights[*r], false, bound, best);
+            if (widths[*r] != heights[*r]) { evaluate(*r, heights[*r], widths[*r], true, bound, best); }
+            if (best.side >= NoBound) { return false; }
+
+            Length w = best.rotated ? heights[*r] : widths[*r];
+            Length h = best.rotated ? widths[*r] : heights[*r];
+            xs[*r] = best.x;
+            ys[*r] = best.y;
+            rotations[*r] = best.rotated;
+            placed.push(best.x, best.y, w, h);
+            square.place(*r, best.x + w, best.y + h);
+            if (isScored) { raster.fill(best.x, best.y, w, h); }
+            corners.push_back({ best.x + w, best.y });
+            corners.push_back({ best.x, best.y + h });
+        }
+        return true;
+    }
+
+    Length side() const { return square.side(); }
+    // number of rectangles placed by the last decoding, which is the progress of a failed one.
+    int placedNum() const { return placed.size(); }
+
+    // the last decoding must succeed.
+    void toOutput(pb::RectPacking::Output &output) const {
+        output.clear_placements();
+        for (ID r = 0; r < static_cast<ID>(widths.size()); ++r) {
+            auto &placement(*output.add_placements());
+            placement.set_id(r);
+            placement.set_x(xs[r]);
+            placement.set_y(ys[r]);
+            placement.set_rotated(rotations[r]);
+        }
+        output.set_length(side());
+    }
+
+protected:
+    struct Point {
+        Coord x;
+        Coord y;
+    };
+
+    struct Candidate {
+        Coord x;
+        Coord y;
+        bool rotated;
+        Length side;
+        SummedAreaTable::Area waste; // vacant area below the rectangle.
+
+        bool isBetterThan(const Candidate &c) const {
+            if (side != c.side) { return (side < c.side); }
+            if (waste != c.waste) { return (waste < c.waste); }
+            return (y != c.y) ? (y < c.y) : (x < c.x);
+        }
+    };
+
+
+    void evaluate(ID r, Length w, Length h, bool rotated, Length bound, Candidate &best) const {
+        for (auto c = corners.begin(); c != corners.end(); ++c) {
+            if ((c->x + w > bound) || (c->y + h > bound)) { continue; }
+            Candidate candidate = { c->x, c->y, rotated, square.sideAfterMove(r, c->x + w, c->y + h), 0 };
+            if (isScored) { candidate.waste = raster.vacant(c->x, 0, w, c->y); }
+            if (!candidate.isBetterThan(best)) { continue; } // the overlap test is the expensive part.
+            if (placed.isOverlapped(c->x, c->y, w, h)) { continue; }
+            best = candidate;
+        }
+    }
+
+
+    List<Length> widths;
+    List<Length> heights;
+
+    List<Coord> xs;
+    List<Coord> ys;
+    List<bool> rotations;
+
+    OverlapKernel placed; // placed rectangles in placement order.
+    BoundingSquare square;
+    List<Point> corners; // candidate positions.
+
+    Length totalLength; // sum of the longer side of all rectangles.
+    bool isScored; // whether the candidates are scored by the vacant area below them.
+    SummedAreaTable raster;
+};
+
+}
+
+
+#endif // SMART_CK_RECT_PACKING_BOTTOM_LEFT_DECODER_H
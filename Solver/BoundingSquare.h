@@ -0,0 +1,180 @@
+////////////////////////////////
+/// usage : 1.	track the side length of the bounding square incrementally under single-rectangle moves.
+///
+/// note  : 1.	right and top edges are counted in bucketed histograms indexed by coordinate.
+///         2.	a two-level bitmap over the non-empty buckets finds the largest and the second
+///             largest edge with a few bit scans instead of a scan over all placements.
+////////////////////////////////
+
+#ifndef SMART_CK_RECT_PACKING_BOUNDING_SQUARE_H
+#define SMART_CK_RECT_PACKING_BOUNDING_SQUARE_H
+
+
+#include "Config.h"
+
+#include <algorithm>
+
+#include "Common.h"
+#include "Utility.h"
+
+
+namespace ck {
+
+// order statistics over a multiset of non-negative edge coordinates.
+class EdgeHistogram {
+public:
+    static constexpr Length DefaultMaxEdge = 1024;
+
+
+    EdgeHistogram(Length maxEdge = DefaultMaxEdge) { reset(maxEdge); }
+
+
+    // remove all edges and prepare buckets for edges in [0, maxEdge].
+    void reset(Length maxEdge = DefaultMaxEdge) {
+        counts.assign(maxEdge + 1, 0);
+        words.assign((maxEdge >> Bit::WordBitShift) + 1, 0);
+        summary.assign((words.size() >> Bit::WordBitShift) + 1, 0);
+        top = 0;
+    }
+
+    void add(Length edge) {
+        if (edge >= static_cast<Length>(counts.size())) { grow(edge); }
+        if (counts[edge]++ == 0) { setBit(edge); }
+        if (edge > top) { top = edge; }
+    }
+    // the edge must have been added.
+    void remove(Length edge) {
+        if (--counts[edge] != 0) { return; }
+        clearBit(edge);
+        if (edge == top) { top = floor(edge - 1); }
+    }
+    void move(Length oldEdge, Length newEdge) {
+        if (oldEdge == newEdge) { return; }
+        add(newEdge); // add first so that the max does not fall back in vain.
+        remove(oldEdge);
+    }
+
+    // the largest edge (0 if empty).
+    Length max() const { return top; }
+    // the largest edge after removing one occurrence of the largest edge.
+    Length secondMax() const { return (counts[top] > 1) ? top : floor(top - 1); }
+    // the largest edge after removing one occurrence of the given edge which must have been added.
+    Length maxWithout(Length edge) const { return (edge == top) ? secondMax() : top; }
+
+    // the largest non-empty bucket no greater than edge (0 if there is none).
+    Length floor(Length edge) const {
+        if (edge < 0) { return 0; }
+        int w = (edge >> Bit::WordBitShift);
+        Bit::Word bits = words[w] & Bit::lowMask(edge & Bit::WordBitMask);
+        if (bits) { return (w << Bit::WordBitShift) + Bit::highest(bits); }
+        if (--w < 0) { return 0; }
+        int s = (w >> Bit::WordBitShift);
+        for (bits = summary[s] & Bit::lowMask(w & Bit::WordBitMask); !bits; bits = summary[s]) {
+            if (--s < 0) { return 0; }
+        }
+        w = (s << Bit::WordBitShift) + Bit::highest(bits);
+        return (w << Bit::WordBitShift) + Bit::highest(words[w]);
+    }
+
+protected:
+    void grow(Length edge) {
+        Length capacity = (std::max)(edge + 1, static_cast<Length>(counts.size()) * 2);
+        counts.resize(capacity, 0);
+        words.resize((capacity >> Bit::WordBitShift) + 1, 0);
+        summary.resize((words.size() >> Bit::WordBitShift) + 1, 0);
+    }
+
+    void setBit(Length edge) {
+        int w = (edge >> Bit::WordBitShift);
+        words[w] |= (1ull << (edge & Bit::WordBitMask));
+        summary[w >> Bit::WordBitShift] |= (1ull << (w & Bit::WordBitMask));
+    }
+    void clearBit(Length edge) {
+        int w = (edge >> Bit::WordBitShift);
+        words[w] &= ~(1ull << (edge & Bit::WordBitMask));
+        if (words[w] == 0) { summary[w >> Bit::WordBitShift] &= ~(1ull << (w & Bit::WordBitMask)); }
+    }
+
+
+    List<int> counts; // counts[e] is the number of edges at coordinate e.
+    List<Bit::Word> words; // the e_th bit is set if counts[e] > 0.
+    List<Bit::Word> summary; // the w_th bit is set if words[w] != 0.
+    Length top; // the largest edge.
+};
+
+// the side length of the square which contains all placed rectangles.
+class BoundingSquare {
+public:
+    static constexpr Length InvalidEdge = -1;
+
+
+    BoundingSquare(ID rectNum = 0, Length maxCoord = EdgeHistogram::DefaultMaxEdge) { reset(rectNum, maxCoord); }
+
+
+    void reset(ID rectNum, Length maxCoord = EdgeHistogram::DefaultMaxEdge) {
+        rights.assign(rectNum, InvalidEdge);
+        tops.assign(rectNum, InvalidEdge);
+        rightEdges.reset(maxCoord);
+        topEdges.reset(maxCoord);
+    }
+
+    // the rectangle must not have been placed.
+    void place(ID r, Length right, Length top) {
+        rights[r] = right;
+        tops[r] = top;
+        rightEdges.add(right);
+        topEdges.add(top);
+    }
+    // the rectangle must have been placed.
+    void remove(ID r) {
+        rightEdges.remove(rights[r]);
+        topEdges.remove(tops[r]);
+        rights[r] = InvalidEdge;
+        tops[r] = InvalidEdge;
+    }
+    // the rectangle must have been placed.
+    void move(ID r, Length right, Length top) {
+        rightEdges.move(rights[r], right);
+        topEdges.move(tops[r], top);
+        rights[r] = right;
+        tops[r] = top;
+    }
+
+    bool isPlaced(ID r) const { return (rights[r] != InvalidEdge); }
+
+    Length width() const { return rightEdges.max(); }
+    Length height() const { return topEdges.max(); }
+    Length side() const { return (std::max)(width(), height()); }
+
+    // the second largest right/top edge which becomes the width/height if the outmost rectangle leaves.
+    Length secondWidth() const { return rightEdges.secondMax(); }
+    Length secondHeight() const { return topEdges.secondMax(); }
+
+    // the side length if the right and top edges of rectangle r were moved to (right, top).
+    Length sideAfterMove(ID r, Length right, Length top) const {
+        Length w = isPlaced(r) ? rightEdges.maxWithout(rights[r]) : width();
+        Length h = isPlaced(r) ? topEdges.maxWithout(tops[r]) : height();
+        return (std::max)((std::max)(w, right), (std::max)(h, top));
+    }
+    // the side length if rectangle r was taken away. the rectangle must have been placed.
+    Length sideWithout(ID r) const {
+        return (std::max)(rightEdges.maxWithout(rights[r]), topEdges.maxWithout(tops[r]));
+    }
+    // the change of the objective if rectangle r was moved.
+    Length deltaOfMove(ID r, Length right, Length top) const { return sideAfterMove(r, right, top) - side(); }
+
+    Length right(ID r) const { return rights[r]; }
+    Length top(ID r) const { return tops[r]; }
+
+protected:
+    List<Length> rights; // rights[r] is the right edge of rectangle r.
+    List<Length> tops; // tops[r] is the top edge of rectangle r.
+
+    EdgeHistogram rightEdges;
+    EdgeHistogram topEdges;
+};
+
+}
+
+
+#endif // SMART_CK_RECT_PACKING_BOUNDING_SQUARE_H
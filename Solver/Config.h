@@ -71,6 +71,12 @@
 #else
 #define _CC_CLANG  0
 #endif // __clang__
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__) // avx2 code can be built for x86 and selected at runtime.
+#define _SIMD_AVX2  1
+#else
+#define _SIMD_AVX2  0
+#endif // x86
 #pragma endregion PlatformCheck
 
 #pragma region LinkLibraryCheck
@@ -6,8 +6,15 @@ using namespace std;
 
 namespace ck {
 
-const set<char> CsvReader::NewLineChars = { '\r', '\n' };
-const set<char> CsvReader::SpaceChars = { ' ', '\t' };
-const set<char> CsvReader::EndCellChars = { CommaChar, '\r', '\n' };
+CsvReader::CharClassTable CsvReader::makeCharClasses() {
+    CharClassTable classes;
+    classes.fill(0);
+    classes['\r'] = classes['\n'] = CharClass::NewLine | CharClass::EndCell;
+    classes[' '] = classes['\t'] = CharClass::Space;
+    classes[static_cast<unsigned char>(CommaChar)] = CharClass::EndCell;
+    return classes;
+}
+
+const CsvReader::CharClassTable CsvReader::CharClasses = CsvReader::makeCharClasses();
 
 }
@@ -1,7 +1,7 @@
 ////////////////////////////////
 /// usage : 1.	read csv file into an jagged array.
 /// 
-/// note  : 1.	
+/// note  : 1.	characters are classified by a table indexed by the byte instead of set lookups.
 ////////////////////////////////
 
 #ifndef SMART_CK_RECT_PACKING_CSV_READER_H
@@ -12,9 +12,11 @@
 #include <fstream>
 #include <sstream>
 #include <string>
-#include <set>
+#include <array>
 #include <vector>
 
+#include "MappedFile.h"
+
 
 // [off] increase readability instead of stabilization in debug mode (avoid stack overflow).
 #define SMART_CK_RECT_PACKING_CSV_READER_RECURSIVE_VERSION  0
@@ -33,8 +35,26 @@ public:
     const std::vector<Row>& scan(std::ostringstream &oss) {
         oss << '\n'; // add a sentinel so that end of file check is only necessary in onNewLine().
         data = oss.str();
-        begin = const_cast<char*>(data.data());  // the const cast can be omitted since C++17.
-        end = begin + data.size();
+        return scan(const_cast<char*>(data.data()), data.size()); // the const cast can be omitted since C++17.
+    }
+    const std::vector<Row>& scan(std::ifstream &ifs) {
+        std::ostringstream oss;
+        oss << ifs.rdbuf();
+        return scan(oss);
+    }
+    // the mapped file is scanned in place if its last line break can be the sentinel.
+    const std::vector<Row>& scan(const std::string &path) {
+        if (!file.open(path)) { return rows; }
+        if ((file.size() > 0) && (file.data()[file.size() - 1] == '\n')) { return scan(file.data(), file.size()); }
+        std::ostringstream oss;
+        oss.write(file.data(), file.size());
+        return scan(oss);
+    }
+
+protected:
+    const std::vector<Row>& scan(char *text, size_t size) {
+        begin = text;
+        end = begin + size;
 
         #if SMART_CK_RECT_PACKING_CSV_READER_RECURSIVE_VERSION
         onNewLine(begin);
@@ -44,16 +64,10 @@ public:
 
         return rows;
     }
-    const std::vector<Row>& scan(std::ifstream &ifs) {
-        std::ostringstream oss;
-        oss << ifs.rdbuf();
-        return scan(oss);
-    }
 
-protected:
     #if SMART_CK_RECT_PACKING_CSV_READER_RECURSIVE_VERSION
     void onNewLine(char *s) {
-        while ((s != end) && (NewLineChars.find(*s) != NewLineChars.end())) { ++s; } // remove empty lines.
+        while ((s != end) && isNewLine(*s)) { ++s; } // remove empty lines.
         if (s == end) { return; }
 
         rows.push_back(Row());
@@ -62,7 +76,7 @@ protected:
     }
 
     void onSpace(char *s) {
-        while (SpaceChars.find(*s) != SpaceChars.end()) { ++s; } // trim spaces.
+        while (isSpace(*s)) { ++s; } // trim spaces.
 
         onValue(s);
     }
@@ -71,48 +85,48 @@ protected:
         rows.back().push_back(s);
 
         char c = *s;
-        if (EndCellChars.find(c) == EndCellChars.end()) {
-            while (EndCellChars.find(*(++s)) == EndCellChars.end()) {}
+        if (!isEndCell(c)) {
+            while (!isEndCell(*(++s))) {}
             c = *s;
 
             char *space = s;
-            while (SpaceChars.find(*(space - 1)) != SpaceChars.end()) { --space; }
+            while (isSpace(*(space - 1))) { --space; }
             *space = 0; // trim spaces and remove comma or line ending.
         } else { // empty cell.
             *s = 0;
         }
 
         ++s;
-        (NewLineChars.find(c) != NewLineChars.end()) ? onNewLine(s) : onSpace(s);
+        isNewLine(c) ? onNewLine(s) : onSpace(s);
     }
     #else // in case there is no Tail-Call Optimization which leads to the stack overflow.
     void onNewLine_opt(char *s) {
 Label_OnNewLine:
-        while ((s != end) && (NewLineChars.find(*s) != NewLineChars.end())) { ++s; } // remove empty lines.
+        while ((s != end) && isNewLine(*s)) { ++s; } // remove empty lines.
         if (s == end) { return; }
 
         rows.push_back(Row());
 
 Label_OnSpace:
-        while (SpaceChars.find(*s) != SpaceChars.end()) { ++s; } // trim spaces.
+        while (isSpace(*s)) { ++s; } // trim spaces.
 
 //Label_OnValue:
         rows.back().push_back(s);
 
         char c = *s;
-        if (EndCellChars.find(c) == EndCellChars.end()) {
-            while (EndCellChars.find(*(++s)) == EndCellChars.end()) {}
+        if (!isEndCell(c)) {
+            while (!isEndCell(*(++s))) {}
             c = *s;
 
             char *space = s;
-            while (SpaceChars.find(*(space - 1)) != SpaceChars.end()) { --space; }
+            while (isSpace(*(space - 1))) { --space; }
             *space = 0; // trim spaces and remove comma or line ending.
         } else { // empty cell.
             *s = 0;
         }
 
         ++s;
-        if (NewLineChars.find(c) != NewLineChars.end()) {
+        if (isNewLine(c)) {
             goto Label_OnNewLine;
         } else {
             goto Label_OnSpace;
@@ -123,14 +137,22 @@ Label_OnSpace:
     // TODO[ck][2]: handle quote (comma will not end cell).
     // EXTEND[ck][5]: make trim space configurable.
 
-    static const std::set<char> NewLineChars;
-    static const std::set<char> SpaceChars;
-    static const std::set<char> EndCellChars;
+    enum CharClass { NewLine = 0x1, Space = 0x2, EndCell = 0x4 }; // bit flags since a char may be in several classes.
+    using CharClassTable = std::array<unsigned char, 256>;
+
+    static CharClassTable makeCharClasses();
+
+    static bool isNewLine(char c) { return (CharClasses[static_cast<unsigned char>(c)] & CharClass::NewLine) != 0; }
+    static bool isSpace(char c) { return (CharClasses[static_cast<unsigned char>(c)] & CharClass::Space) != 0; }
+    static bool isEndCell(char c) { return (CharClasses[static_cast<unsigned char>(c)] & CharClass::EndCell) != 0; }
+
+    static const CharClassTable CharClasses;
 
     char *begin;
     const char *end;
 
     std::string data;
+    MappedFile file; // the cells may point into the mapped file.
     std::vector<Row> rows;
 };
 
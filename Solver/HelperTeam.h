@@ -0,0 +1,114 @@
+////////////////////////////////
+/// usage : 1.	a worker and its helper threads run the tasks of a batch together.
+///
+/// note  : 1.	the batch is handed off by bumping an atomic epoch instead of a barrier or
+///             a job queue, and the tasks are claimed by an atomic counter. the caller takes
+///             part in the batch as thread 0 and returns once every task is finished.
+///         2.	idle helpers spin and then yield, so they are only meant for batches issued
+///             back to back by a busy worker.
+///         3.	run() must only be called by the thread which owns the team.
+////////////////////////////////
+
+#ifndef SMART_CK_RECT_PACKING_HELPER_TEAM_H
+#define SMART_CK_RECT_PACKING_HELPER_TEAM_H
+
+
+#include "Config.h"
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+#include "Common.h"
+
+
+namespace ck {
+
+class HelperTeam {
+public:
+    using Task = std::function<void(int taskIndex, int threadIndex)>;
+
+
+    static constexpr int SpinNum = 1024; // number of polls before yielding.
+
+
+    // threadNum includes the caller, so (threadNum - 1) helper threads are launched.
+    HelperTeam(int threadNum) : batch(0), claim(0), end(0), epoch(0), isStopped(false) {
+        for (int t = 1; t < threadNum; ++t) { helpers.emplace_back([this, t]() { help(t); }); }
+    }
+    ~HelperTeam() {
+        isStopped.store(true, std::memory_order_release);
+        for (auto h = helpers.begin(); h != helpers.end(); ++h) { h->join(); }
+    }
+
+
+    int threadNum() const { return static_cast<int>(helpers.size()) + 1; }
+
+    // call task(taskIndex, threadIndex) for each taskIndex in [0, taskNum).
+    // the threadIndex in [0, threadNum()) tells which scratch space the task may use.
+    void run(int taskNum, const Task &newTask) {
+        Word tag = static_cast<Word>(++batch) << IndexBitNum;
+        task = &newTask;
+        finishedTaskNum.store(0, std::memory_order_relaxed);
+        end.store(tag | static_cast<Word>(taskNum), std::memory_order_release);
+        claim.store(tag, std::memory_order_release);
+        epoch.store(batch, std::memory_order_release); // hand off the batch.
+
+        work(0, batch);
+        for (int spin = 0; finishedTaskNum.load(std::memory_order_acquire) < taskNum; ++spin) {
+            if (spin >= SpinNum) { std::this_thread::yield(); }
+        }
+    }
+
+protected:
+    using Word = unsigned long long; // the batch number in the high half and the task index in the low half.
+    using Batch = unsigned;
+
+
+    static constexpr int IndexBitNum = 32;
+    static constexpr Word IndexMask = (1ull << IndexBitNum) - 1;
+
+
+    void help(int threadIndex) {
+        for (Batch seen = 0;;) {
+            Batch b;
+            for (int spin = 0; (b = epoch.load(std::memory_order_acquire)) == seen; ++spin) {
+                if (isStopped.load(std::memory_order_acquire)) { return; }
+                if (spin >= SpinNum) { std::this_thread::yield(); }
+            }
+            seen = b;
+            work(threadIndex, b);
+        }
+    }
+
+    // claim and run tasks of batch b until there is none left.
+    // a late helper never claims tasks of the next batch since the claim is tagged by the batch number.
+    void work(int threadIndex, Batch b) {
+        for (;;) {
+            Word c = claim.load(std::memory_order_acquire);
+            if ((c >> IndexBitNum) != b) { return; }
+            Word e = end.load(std::memory_order_acquire);
+            if (((e >> IndexBitNum) != b) || ((c & IndexMask) >= (e & IndexMask))) { return; }
+            if (!claim.compare_exchange_weak(c, c + 1, std::memory_order_acq_rel)) { continue; }
+            (*task)(static_cast<int>(c & IndexMask), threadIndex);
+            finishedTaskNum.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+
+    List<std::thread> helpers;
+
+    Batch batch; // number of batches issued by the owner.
+    const Task *task; // written by the owner before the batch is handed off.
+
+    std::atomic<Word> claim; // the next task to run.
+    std::atomic<Word> end; // the number of tasks.
+    std::atomic<int> finishedTaskNum;
+    std::atomic<Batch> epoch; // the latest batch handed off.
+    std::atomic<bool> isStopped;
+};
+
+}
+
+
+#endif // SMART_CK_RECT_PACKING_HELPER_TEAM_H
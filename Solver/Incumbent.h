@@ -0,0 +1,140 @@
+////////////////////////////////
+/// usage : 1.	the best solution shared by all workers without locks.
+///
+/// note  : 1.	the best side length is an atomic which is lowered by compare-and-swap,
+///             so workers can read it for pruning at the cost of a single load.
+///         2.	the solution is kept in a compact buffer protected by a sequence lock.
+///             readers never block writers and retry if a write happened during the copy.
+///         3.	writers only publish strict improvements, so they rarely contend.
+////////////////////////////////
+
+#ifndef SMART_CK_RECT_PACKING_INCUMBENT_H
+#define SMART_CK_RECT_PACKING_INCUMBENT_H
+
+
+#include "Config.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "Common.h"
+#include "RectPacking.pb.h"
+
+
+namespace ck {
+
+class Incumbent {
+public:
+    using Word = unsigned long long; // a compact placement.
+    using Sequence = unsigned;
+
+
+    static constexpr Length NoSolution = (1 << 30);
+    static constexpr ID NoOwner = -1;
+
+
+    Incumbent(ID rectNum = 0) { reset(rectNum); }
+
+
+    // must not be called concurrently with any other method.
+    void reset(ID rectNum) {
+        placementNum = rectNum;
+        placements.reset(new std::atomic<Word>[rectNum]);
+        for (ID r = 0; r < rectNum; ++r) { placements[r].store(0, std::memory_order_relaxed); }
+        bestLength.store(NoSolution, std::memory_order_relaxed);
+        bufferLength.store(NoSolution, std::memory_order_relaxed);
+        bufferOwner.store(NoOwner, std::memory_order_relaxed);
+        seq.store(0, std::memory_order_release);
+    }
+
+    // the best side length which has been published (NoSolution if there is none).
+    // the solution itself may still be on its way into the buffer.
+    Length length() const { return bestLength.load(std::memory_order_acquire); }
+    // the worker who published the buffered solution.
+    ID owner() const { return bufferOwner.load(std::memory_order_acquire); }
+
+    // return true if the output is better than all published solutions.
+    // placements of the output must be listed in the order of rectangle id.
+    bool publish(const pb::RectPacking::Output &output, ID workerId) {
+        if (output.placements().size() != placementNum) { return false; } // incomplete solution.
+
+        Length len = output.length();
+        Length best = bestLength.load(std::memory_order_relaxed);
+        do {
+            if (len >= best) { return false; }
+        } while (!bestLength.compare_exchange_weak(best, len, std::memory_order_acq_rel));
+
+        Sequence s = lockForWrite();
+        if (len < bufferLength.load(std::memory_order_relaxed)) { // a better one may have been written meanwhile.
+            for (ID r = 0; r < placementNum; ++r) {
+                const auto &p(output.placements(r));
+                placements[r].store(encode(p.x(), p.y(), p.rotated()), std::memory_order_relaxed);
+            }
+            bufferLength.store(len, std::memory_order_relaxed);
+            bufferOwner.store(workerId, std::memory_order_relaxed);
+        }
+        seq.store(s + 2, std::memory_order_release);
+        return true;
+    }
+
+    // copy a consistent snapshot of the best solution. return false if there is none.
+    bool read(pb::RectPacking::Output &output) const {
+        for (;;) {
+            Sequence s = seq.load(std::memory_order_acquire);
+            if (s & 1) { std::this_thread::yield(); continue; } // a write is in progress.
+
+            Length len = bufferLength.load(std::memory_order_relaxed);
+            if (len >= NoSolution) { return false; }
+            output.clear_placements();
+            for (ID r = 0; r < placementNum; ++r) {
+                Word w = placements[r].load(std::memory_order_relaxed);
+                auto &p(*output.add_placements());
+                p.set_id(r);
+                p.set_x(static_cast<Coord>(w >> CoordBitNum));
+                p.set_y(static_cast<Coord>((w & CoordMask) >> 1));
+                p.set_rotated((w & 1) != 0);
+            }
+            output.set_length(len);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq.load(std::memory_order_relaxed) == s) { return true; }
+        }
+    }
+
+protected:
+    static constexpr int CoordBitNum = 32;
+    static constexpr Word CoordMask = (1ull << CoordBitNum) - 1;
+
+    // x in the high half, y and the rotation flag in the low half.
+    static Word encode(Coord x, Coord y, bool rotated) {
+        return (static_cast<Word>(static_cast<unsigned>(x)) << CoordBitNum)
+            | ((static_cast<Word>(static_cast<unsigned>(y)) << 1) & CoordMask) | (rotated ? 1 : 0);
+    }
+
+    // make the sequence odd.
+    Sequence lockForWrite() {
+        for (;;) {
+            Sequence s = seq.load(std::memory_order_relaxed);
+            if (!(s & 1) && seq.compare_exchange_weak(s, s + 1, std::memory_order_acquire)) {
+                std::atomic_thread_fence(std::memory_order_release); // keep the buffer stores after the odd sequence.
+                return s;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+
+    ID placementNum;
+    std::unique_ptr<std::atomic<Word>[]> placements;
+
+    std::atomic<Length> bestLength;
+    std::atomic<Length> bufferLength;
+    std::atomic<ID> bufferOwner;
+    std::atomic<Sequence> seq; // odd while a writer is updating the buffer.
+};
+
+}
+
+
+#endif // SMART_CK_RECT_PACKING_INCUMBENT_H
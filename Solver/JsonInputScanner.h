@@ -0,0 +1,142 @@
+////////////////////////////////
+/// usage : 1.	scan the json instance of the rectangle packing problem without protobuf reflection.
+///
+/// note  : 1.	only the exact shape {"rectangles":[{"id":1,"width":2,"height":3},...]} is accepted,
+///             with any white spaces, any field order and missing fields as 0. anything else
+///             (escapes, null, floats, unknown or duplicated keys, trailing content) fails the scan,
+///             and the caller should fall back to the general json parser.
+///         2.	the text is scanned in place and the numbers are written into the message directly.
+////////////////////////////////
+
+#ifndef SMART_CK_RECT_PACKING_JSON_INPUT_SCANNER_H
+#define SMART_CK_RECT_PACKING_JSON_INPUT_SCANNER_H
+
+
+#include <cstddef>
+#include <cstring>
+
+#include "RectPacking.pb.h"
+
+
+namespace pb {
+
+class JsonInputScanner {
+public:
+    // the input may be partially filled if the scan fails.
+    static bool scan(const char *data, size_t size, RectPacking::Input &input) {
+        return JsonInputScanner(data, size).scanInput(input);
+    }
+
+protected:
+    enum Field { Id = 0x1, Width = 0x2, Height = 0x4 };
+
+
+    static constexpr size_t MinRectangleSize = 32; // bytes of a compact rectangle for reserving space.
+
+
+    JsonInputScanner(const char *data, size_t size) : cur(data), end(data + size) {}
+
+
+    bool scanInput(RectPacking::Input &input) {
+        if (!take('{')) { return false; }
+        if (take('}')) { return isEnd(); }
+        if (!takeKey("rectangles", 10) || !take('[')) { return false; }
+        auto &rectangles(*input.mutable_rectangles());
+        rectangles.Reserve(static_cast<int>((end - cur) / MinRectangleSize));
+        if (!take(']')) {
+            do {
+                if (!scanRectangle(*rectangles.Add())) { return false; }
+            } while (take(','));
+            if (!take(']')) { return false; }
+        }
+        return take('}') && isEnd();
+    }
+
+    bool scanRectangle(Rectangle &rect) {
+        if (!take('{')) { return false; }
+        if (take('}')) { return true; }
+        int fields = 0;
+        do {
+            Field field;
+            google::protobuf::int32 value;
+            if (!scanField(field) || (fields & field) || !scanInt(value)) { return false; }
+            fields |= field;
+            if (field == Field::Id) {
+                rect.set_id(value);
+            } else if (field == Field::Width) {
+                rect.set_width(value);
+            } else {
+                rect.set_height(value);
+            }
+        } while (take(','));
+        return take('}');
+    }
+
+    bool scanField(Field &field) {
+        if (takeKey("id", 2)) {
+            field = Field::Id;
+        } else if (takeKey("width", 5)) {
+            field = Field::Width;
+        } else if (takeKey("height", 6)) {
+            field = Field::Height;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    // a json integer without fraction or exponent which fits in int32.
+    bool scanInt(google::protobuf::int32 &value) {
+        static constexpr long long MaxAbs = 2147483648ll;
+        skipSpace();
+        bool isNegative = (cur != end) && (*cur == '-');
+        if (isNegative) { ++cur; }
+        if ((cur == end) || (*cur < '0') || (*cur > '9')) { return false; }
+        if ((*cur == '0') && (cur + 1 != end) && (cur[1] >= '0') && (cur[1] <= '9')) { return false; } // leading zero.
+        long long n = 0;
+        for (; (cur != end) && (*cur >= '0') && (*cur <= '9'); ++cur) {
+            n = n * 10 + (*cur - '0');
+            if (n > MaxAbs) { return false; }
+        }
+        if (!isNegative && (n == MaxAbs)) { return false; }
+        value = static_cast<google::protobuf::int32>(isNegative ? -n : n);
+        return true;
+    }
+
+    // the quoted key and the following colon.
+    bool takeKey(const char *key, size_t len) {
+        skipSpace();
+        if ((static_cast<size_t>(end - cur) < len + 2) || (*cur != '"')
+            || (std::memcmp(cur + 1, key, len) != 0) || (cur[len + 1] != '"')) {
+            return false;
+        }
+        cur += len + 2;
+        return take(':');
+    }
+
+    // consume c if it is the next non-blank character.
+    bool take(char c) {
+        skipSpace();
+        if ((cur == end) || (*cur != c)) { return false; }
+        ++cur;
+        return true;
+    }
+
+    bool isEnd() {
+        skipSpace();
+        return (cur == end);
+    }
+
+    void skipSpace() {
+        while ((cur != end) && ((*cur == ' ') || (*cur == '\n') || (*cur == '\r') || (*cur == '\t'))) { ++cur; }
+    }
+
+
+    const char *cur;
+    const char *end;
+};
+
+}
+
+
+#endif // SMART_CK_RECT_PACKING_JSON_INPUT_SCANNER_H
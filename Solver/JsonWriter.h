@@ -0,0 +1,130 @@
+////////////////////////////////
+/// usage : 1.	format solutions into json text without protobuf reflection.
+///
+/// note  : 1.	the text is byte-compatible with protobufToJson() (compact submission line and
+///             pretty output with 1-space indent), so the checker and analyzer are not affected.
+///         2.	everything is appended to one buffer which is written to the file in one call.
+///         3.	submissions with strings that protobuf may escape differently or with a non-zero
+///             objective are formatted by protobuf instead.
+////////////////////////////////
+
+#ifndef SMART_CK_RECT_PACKING_JSON_WRITER_H
+#define SMART_CK_RECT_PACKING_JSON_WRITER_H
+
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "PbReader.h"
+#include "RectPacking.pb.h"
+
+
+namespace pb {
+
+class JsonWriter {
+public:
+    static constexpr size_t DefaultCapacity = (1 << 16);
+    static constexpr size_t PlacementSize = 64; // bytes of a formatted placement for reserving space.
+
+
+    JsonWriter(size_t capacity = DefaultCapacity) { buffer.reserve(capacity); }
+
+
+    // the same as protobufToJson(submission, false).
+    void write(const Submission &submission) {
+        if (!isPlain(submission)) {
+            append(protobufToJson(submission, false));
+            return;
+        }
+        append("{\"author\":"); appendString(submission.author());
+        append(",\"algorithm\":"); appendString(submission.algorithm());
+        append(",\"thread\":"); appendString(submission.thread());
+        append(",\"cpu\":"); appendString(submission.cpu());
+        append(",\"ram\":"); appendString(submission.ram());
+        append(",\"language\":"); appendString(submission.language());
+        append(",\"compiler\":"); appendString(submission.compiler());
+        append(",\"os\":"); appendString(submission.os());
+        append(",\"problem\":"); appendString(submission.problem());
+        append(",\"instance\":"); appendString(submission.instance());
+        append(",\"duration\":"); appendString(submission.duration());
+        append(",\"obj\":0");
+        append(",\"email\":"); appendString(submission.email());
+        append(",\"date\":"); appendString(submission.date());
+        append("}");
+    }
+
+    // the same as protobufToJson(output).
+    void write(const RectPacking::Output &output) {
+        buffer.reserve(buffer.size() + PlacementSize * output.placements().size() + PlacementSize);
+        if (output.placements().empty()) {
+            append("{\n \"placements\": [],\n");
+        } else {
+            append("{\n \"placements\": [\n");
+            for (auto p = output.placements().begin(); p != output.placements().end(); ++p) {
+                if (p != output.placements().begin()) { append(",\n"); }
+                append("  {\n   \"id\": "); appendInt(p->id());
+                append(",\n   \"x\": "); appendInt(p->x());
+                append(",\n   \"y\": "); appendInt(p->y());
+                append(p->rotated() ? ",\n   \"rotated\": true\n  }" : ",\n   \"rotated\": false\n  }");
+            }
+            append("\n ],\n");
+        }
+        append(" \"length\": "); appendInt(output.length());
+        append("\n}\n");
+    }
+
+    void newLine() { buffer.push_back('\n'); }
+
+    // write the whole buffer in one call.
+    // the file is opened in text mode like std::ofstream, so the line ends are the same as before on windows.
+    bool save(const std::string &path) const {
+        std::FILE *file = std::fopen(path.c_str(), "w");
+        if (file == nullptr) { return false; }
+        std::setvbuf(file, nullptr, _IONBF, 0); // skip the stdio buffer since the text is already in one piece.
+        bool isWritten = (std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size());
+        return (std::fclose(file) == 0) && isWritten;
+    }
+
+protected:
+    // strings are copied as they are if none of their characters needs to be escaped.
+    static bool isPlain(const std::string &str) {
+        for (auto c = str.begin(); c != str.end(); ++c) {
+            if ((*c < 0x20) || (*c > 0x7e) || (std::strchr("\"\\<>&'=", *c) != nullptr)) { return false; }
+        }
+        return true;
+    }
+    static bool isPlain(const Submission &s) {
+        return (s.obj() == 0) && isPlain(s.author()) && isPlain(s.algorithm()) && isPlain(s.thread())
+            && isPlain(s.cpu()) && isPlain(s.ram()) && isPlain(s.language()) && isPlain(s.compiler())
+            && isPlain(s.os()) && isPlain(s.problem()) && isPlain(s.instance()) && isPlain(s.duration())
+            && isPlain(s.email()) && isPlain(s.date());
+    }
+
+    void append(const char *str) { buffer.insert(buffer.end(), str, str + std::strlen(str)); }
+    void append(const std::string &str) { buffer.insert(buffer.end(), str.begin(), str.end()); }
+
+    void appendString(const std::string &str) {
+        buffer.push_back('"');
+        append(str);
+        buffer.push_back('"');
+    }
+
+    void appendInt(google::protobuf::int32 value) {
+        char digits[12];
+        char *d = digits + sizeof(digits);
+        unsigned n = (value < 0) ? (0u - static_cast<unsigned>(value)) : static_cast<unsigned>(value);
+        do { *(--d) = static_cast<char>('0' + n % 10); } while ((n /= 10) != 0);
+        if (value < 0) { *(--d) = '-'; }
+        buffer.insert(buffer.end(), d, digits + sizeof(digits));
+    }
+
+
+    std::vector<char> buffer;
+};
+
+}
+
+
+#endif // SMART_CK_RECT_PACKING_JSON_WRITER_H
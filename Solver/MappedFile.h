@@ -0,0 +1,151 @@
+////////////////////////////////
+/// usage : 1.	map a whole file into memory for parsing without copying it.
+///
+/// note  : 1.	the pages are mapped copy-on-write, so parsers may modify the content in place
+///             (e.g., write string terminators) without touching the file on disk.
+///         2.	if the file can not be mapped (e.g., pipes or empty files), it is read into
+///             a buffer owned by the object instead, which is transparent to the caller.
+////////////////////////////////
+
+#ifndef SMART_CK_RECT_PACKING_MAPPED_FILE_H
+#define SMART_CK_RECT_PACKING_MAPPED_FILE_H
+
+
+#include "Config.h"
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <cstddef>
+
+#if _OS_MS_WINDOWS
+// keep min()/max() macros and the rarely used apis out of every file which includes this header.
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif // NOMINMAX
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif // WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif // _OS_MS_WINDOWS
+
+
+namespace ck {
+
+class MappedFile {
+public:
+    MappedFile() : view(nullptr), len(0), isViewMapped(false) {}
+    explicit MappedFile(const std::string &path) : MappedFile() { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+
+    bool open(const std::string &path) {
+        close();
+        return map(path) || read(path);
+    }
+    void close() {
+        if (isViewMapped) { unmap(); }
+        view = nullptr;
+        len = 0;
+        isViewMapped = false;
+        buffer.clear();
+    }
+
+    bool isOpen() const { return (view != nullptr); }
+    bool isMapped() const { return isViewMapped; }
+
+    char* data() { return view; }
+    const char* data() const { return view; }
+    size_t size() const { return len; }
+
+protected:
+    #if _OS_MS_WINDOWS
+    bool map(const std::string &path) {
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) { return false; }
+        LARGE_INTEGER fileSize;
+        HANDLE mapping = nullptr;
+        if (GetFileSizeEx(file, &fileSize) && (fileSize.QuadPart > 0)) {
+            mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        }
+        CloseHandle(file); // the mapping keeps the file open.
+        if (mapping == nullptr) { return false; }
+        view = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+        CloseHandle(mapping); // the view keeps the mapping alive.
+        if (view == nullptr) { return false; }
+        len = static_cast<size_t>(fileSize.QuadPart);
+        isViewMapped = true;
+        return true;
+    }
+    void unmap() { UnmapViewOfFile(view); }
+
+    bool read(const std::string &path) {
+        std::ifstream ifs(path, std::ios::binary);
+        if (!ifs.is_open()) { return false; }
+        buffer.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+        return adoptBuffer();
+    }
+    #else
+    bool map(const std::string &path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) { return false; }
+        struct stat st;
+        void *p = MAP_FAILED;
+        if ((fstat(fd, &st) == 0) && S_ISREG(st.st_mode) && (st.st_size > 0)) {
+            p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd); // the mapping keeps the file open.
+        if (p == MAP_FAILED) { return false; }
+        madvise(p, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+        view = static_cast<char*>(p);
+        len = static_cast<size_t>(st.st_size);
+        isViewMapped = true;
+        return true;
+    }
+    void unmap() { munmap(view, len); }
+
+    // files with no size in advance (e.g., pipes and /proc) are read in chunks until the end.
+    bool read(const std::string &path) {
+        static constexpr size_t ChunkSize = (1 << 16);
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) { return false; }
+        for (;;) {
+            size_t oldSize = buffer.size();
+            buffer.resize(oldSize + ChunkSize);
+            ssize_t n = ::read(fd, buffer.data() + oldSize, ChunkSize);
+            buffer.resize(oldSize + ((n > 0) ? static_cast<size_t>(n) : 0));
+            if (n <= 0) { break; }
+        }
+        ::close(fd);
+        return adoptBuffer();
+    }
+    #endif // _OS_MS_WINDOWS
+
+    bool adoptBuffer() {
+        buffer.push_back('\0'); // make the view of an empty file non-null.
+        view = buffer.data();
+        len = buffer.size() - 1;
+        return true;
+    }
+
+
+    char *view;
+    size_t len;
+    bool isViewMapped;
+    std::vector<char> buffer; // the content if the file is not mapped.
+};
+
+}
+
+
+#endif // SMART_CK_RECT_PACKING_MAPPED_FILE_H
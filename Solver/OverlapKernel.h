@@ -0,0 +1,158 @@
+////////////////////////////////
+/// usage : 1.	test one candidate rectangle against all placed rectangles.
+///
+/// note  : 1.	the placed rectangles are stored as structure of arrays so that 8 of them
+///             are compared by a few AVX2 instructions.
+///         2.	the AVX2 path is selected at runtime, so the binary still runs on cpus without
+///             AVX2 through the scalar loop. building with /arch:AVX2 or -mavx2 skips the check.
+////////////////////////////////
+
+#ifndef SMART_CK_RECT_PACKING_OVERLAP_KERNEL_H
+#define SMART_CK_RECT_PACKING_OVERLAP_KERNEL_H
+
+
+#include "Config.h"
+
+#include <algorithm>
+
+#include <cstdint>
+
+#if _SIMD_AVX2
+#include <immintrin.h>
+#endif // _SIMD_AVX2
+
+#if _SIMD_AVX2 && !_CC_MS_VC
+#define CK_TARGET_AVX2  __attribute__((target("avx2"))) // gcc and clang only emit avx2 in functions asking for it.
+#else
+#define CK_TARGET_AVX2 // msvc emits the intrinsics as they are.
+#endif // _SIMD_AVX2
+
+#include "Common.h"
+#include "Utility.h"
+
+
+namespace ck {
+
+class OverlapKernel {
+public:
+    using Int = std::int32_t;
+
+
+    static constexpr int NoOverlap = -1;
+    static constexpr int BatchSize = 8; // number of int32 lanes in a 256-bit register.
+
+
+    void reserve(int capacity) {
+        xs.reserve(capacity); ys.reserve(capacity);
+        ws.reserve(capacity); hs.reserve(capacity);
+    }
+    void clear() {
+        xs.clear(); ys.clear();
+        ws.clear(); hs.clear();
+    }
+
+    // return the index of the new rectangle.
+    int push(Coord x, Coord y, Length w, Length h) {
+        xs.push_back(x); ys.push_back(y);
+        ws.push_back(w); hs.push_back(h);
+        return size() - 1;
+    }
+    void pop() {
+        xs.pop_back(); ys.pop_back();
+        ws.pop_back(); hs.pop_back();
+    }
+    void set(int i, Coord x, Coord y, Length w, Length h) {
+        xs[i] = x; ys[i] = y;
+        ws[i] = w; hs[i] = h;
+    }
+
+    int size() const { return static_cast<int>(xs.size()); }
+
+    // return the index of the first rectangle since begin which overlaps the candidate, or NoOverlap.
+    int firstOverlap(Coord x, Coord y, Length w, Length h, int begin = 0) const {
+        int n = size();
+        int i = begin;
+        #if _SIMD_AVX2
+        if (isAvx2Enabled()) {
+            int r = firstOverlapAvx2(x, y, w, h, i);
+            if (r != NoOverlap) { return r; }
+        }
+        #endif // _SIMD_AVX2
+        for (; i < n; ++i) {
+            if (isOverlapped(x, y, w, h, i)) { return i; }
+        }
+        return NoOverlap;
+    }
+    bool isOverlapped(Coord x, Coord y, Length w, Length h) const {
+        return (firstOverlap(x, y, w, h) != NoOverlap);
+    }
+
+    // the i_th bit of the mask is set if the rectangle (begin + i) overlaps the candidate.
+    // rectangles no less than size() are ignored.
+    int overlapMask(Coord x, Coord y, Length w, Length h, int begin) const {
+        int n = size();
+        #if _SIMD_AVX2
+        if ((begin + BatchSize <= n) && isAvx2Enabled()) { return overlapMaskAvx2(x, y, w, h, begin); }
+        #endif // _SIMD_AVX2
+        int mask = 0;
+        for (int i = begin, end = (std::min)(begin + BatchSize, n); i < end; ++i) {
+            if (isOverlapped(x, y, w, h, i)) { mask |= (1 << (i - begin)); }
+        }
+        return mask;
+    }
+
+protected:
+    bool isOverlapped(Coord x, Coord y, Length w, Length h, int i) const {
+        return (x < xs[i] + ws[i]) && (xs[i] < x + w) && (y < ys[i] + hs[i]) && (ys[i] < y + h);
+    }
+
+    #if _SIMD_AVX2
+    static bool isAvx2Enabled() {
+        #ifdef __AVX2__
+        return true;
+        #else
+        static const bool enabled = System::supportsAvx2();
+        return enabled;
+        #endif // __AVX2__
+    }
+
+    // test the full batches since i and stop at the first one with an overlap.
+    // return the index of the overlapping rectangle, or NoOverlap with i at the first unchecked one.
+    CK_TARGET_AVX2 int firstOverlapAvx2(Coord x, Coord y, Length w, Length h, int &i) const {
+        int n = size();
+        __m256i cx0 = _mm256_set1_epi32(x);
+        __m256i cy0 = _mm256_set1_epi32(y);
+        __m256i cx1 = _mm256_set1_epi32(x + w);
+        __m256i cy1 = _mm256_set1_epi32(y + h);
+        for (; i + BatchSize <= n; i += BatchSize) {
+            int mask = overlapMask(cx0, cy0, cx1, cy1, i);
+            if (mask) { return i + Bit::lowest(static_cast<Bit::Word>(mask)); }
+        }
+        return NoOverlap;
+    }
+    CK_TARGET_AVX2 int overlapMaskAvx2(Coord x, Coord y, Length w, Length h, int begin) const {
+        return overlapMask(_mm256_set1_epi32(x), _mm256_set1_epi32(y), _mm256_set1_epi32(x + w), _mm256_set1_epi32(y + h), begin);
+    }
+    CK_TARGET_AVX2 int overlapMask(__m256i cx0, __m256i cy0, __m256i cx1, __m256i cy1, int i) const {
+        __m256i x0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(xs.data() + i));
+        __m256i y0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ys.data() + i));
+        __m256i x1 = _mm256_add_epi32(x0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ws.data() + i)));
+        __m256i y1 = _mm256_add_epi32(y0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hs.data() + i)));
+        __m256i hit = _mm256_and_si256(
+            _mm256_and_si256(_mm256_cmpgt_epi32(x1, cx0), _mm256_cmpgt_epi32(cx1, x0)),
+            _mm256_and_si256(_mm256_cmpgt_epi32(y1, cy0), _mm256_cmpgt_epi32(cy1, y0)));
+        return _mm256_movemask_ps(_mm256_castsi256_ps(hit));
+    }
+    #endif // _SIMD_AVX2
+
+
+    List<Int> xs;
+    List<Int> ys;
+    List<Int> ws;
+    List<Int> hs;
+};
+
+}
+
+
+#endif // SMART_CK_RECT_PACKING_OVERLAP_KERNEL_H
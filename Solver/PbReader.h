@@ -1,7 +1,12 @@
 ////////////////////////////////
 /// usage : 1.	data format converters.
 /// 
-/// note  : 1.	
+/// note  : 1.	messages are saved in the binary wire format if the path ends with ".pb".
+///             loading detects the format by the leading characters.
+///         2.	json instances are scanned by a dedicated scanner first, which skips
+///             the reflection based parser for the common shape.
+///         3.	batches are streams of binary messages each of which is preceded by its size in
+///             a varint, the same as writeDelimitedTo() in other protobuf languages.
 ////////////////////////////////
 
 #ifndef SMART_CK_RECT_PACKING_PB_READER_H
@@ -12,6 +17,13 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <type_traits>
+#include <vector>
+
+#include <cstring>
+
+#include "MappedFile.h"
+#include "JsonInputScanner.h"
 
 #pragma warning(push, 0)
 #include "google/protobuf/util/json_util.h"
@@ -35,29 +47,149 @@ std::string protobufToJson(const T &obj, bool pretty = true) {
 }
 
 template<typename T>
-void jsonToProtobuf(const std::string &data, T &obj) {
+bool jsonToProtobuf(const char *data, size_t size, T &obj) {
     google::protobuf::util::JsonParseOptions options;
-    google::protobuf::util::JsonStringToMessage(data, &obj, options);
+    return google::protobuf::util::JsonStringToMessage(google::protobuf::StringPiece(data, size), &obj, options).ok();
+}
+template<typename T>
+bool jsonToProtobuf(const std::string &data, T &obj) { return jsonToProtobuf(data.data(), data.size(), obj); }
+
+template<typename T>
+std::string protobufToBinary(const T &obj) {
+    std::string data;
+    obj.SerializeToString(&data);
+    return data;
+}
+
+template<typename T>
+bool binaryToProtobuf(const char *data, size_t size, T &obj) {
+    return obj.ParseFromArray(data, static_cast<int>(size));
+}
+template<typename T>
+bool binaryToProtobuf(const std::string &data, T &obj) { return binaryToProtobuf(data.data(), data.size(), obj); }
+
+// files with the ".pb" extension are saved in the binary wire format, others in json.
+inline bool isBinaryPath(const std::string &path) {
+    static const std::string BinaryExtension(".pb");
+    return (path.size() >= BinaryExtension.size())
+        && (path.compare(path.size() - BinaryExtension.size(), BinaryExtension.size(), BinaryExtension) == 0);
+}
+
+// json objects are '{' followed by '"' or '}' with optional white spaces in between.
+// binary instances and solutions may also start with white space bytes since '\n' (0x0A) is the tag
+// of the repeated field 1, but the byte after the length is a tag of a rectangle or placement field,
+// which is never '"' (field 4 with length) or '}' (field 15). '{' itself would be the tag of a
+// deprecated group. an empty message is empty data, which is not valid json.
+inline bool isBinaryData(const char *data, size_t size) {
+    auto isSpace = [](char c) { return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n'); };
+    const char *c = data;
+    const char *end = data + size;
+    for (; (c != end) && isSpace(*c); ++c) {}
+    if ((c == end) || (*c != '{')) { return true; }
+    for (++c; (c != end) && isSpace(*c); ++c) {}
+    return (c == end) || ((*c != '"') && (*c != '}'));
+}
+
+template<typename T>
+bool parseJson(const char *data, size_t size, T &obj, std::false_type) {
+    return jsonToProtobuf(data, size, obj);
+}
+template<typename T>
+bool parseJson(const char *data, size_t size, T &obj, std::true_type) {
+    if (JsonInputScanner::scan(data, size, obj)) { return true; }
+    obj.Clear(); // drop the partial result of the scanner.
+    return jsonToProtobuf(data, size, obj);
+}
+
+// detect the format by the content instead of the extension.
+// instances (including the classes derived from RectPacking::Input) go through the scanner.
+template<typename T>
+bool parse(const char *data, size_t size, T &obj) {
+    if (isBinaryData(data, size)) { return binaryToProtobuf(data, size, obj); }
+    return parseJson(data, size, obj, std::is_base_of<RectPacking::Input, T>());
+}
+
+// json files may start with a line of other information (e.g., the submission before the solution).
+template<typename T>
+bool parseWithHeader(const char *data, size_t size, T &obj) {
+    if (parse(data, size, obj)) { return true; }
+    const char *lineEnd = static_cast<const char*>(std::memchr(data, '\n', size));
+    if (isBinaryData(data, size) || (lineEnd == nullptr)) { return false; }
+    obj.Clear();
+    return parse(lineEnd + 1, size - (lineEnd + 1 - data), obj);
 }
 
+// the file is mapped into memory and parsed in place.
 template<typename T>
 static bool load(const std::string &path, T &obj) {
-    std::ifstream ifs(path);
-    if (!ifs.is_open()) { return false; }
-    std::ostringstream oss;
-    oss << ifs.rdbuf();
-    jsonToProtobuf(oss.str(), obj);
+    ck::MappedFile file(path);
+    return file.isOpen() && parse(file.data(), file.size(), obj);
+}
+
+template<typename T>
+static bool loadWithHeader(const std::string &path, T &obj) {
+    ck::MappedFile file(path);
+    return file.isOpen() && parseWithHeader(file.data(), file.size(), obj);
+}
+
+// the varint is consumed if it is complete (at most 64 bits).
+inline bool readVarint(const char *&cur, const char *end, unsigned long long &value) {
+    static constexpr int MaxVarintSize = 10;
+    value = 0;
+    for (int i = 0; (i < MaxVarintSize) && (cur + i != end); ++i) {
+        unsigned char byte = static_cast<unsigned char>(cur[i]);
+        value |= static_cast<unsigned long long>(byte & 0x7f) << (7 * i);
+        if ((byte & 0x80) == 0) {
+            cur += i + 1;
+            return true;
+        }
+    }
+    return false;
+}
+inline void appendVarint(std::string &data, unsigned long long value) {
+    for (; value >= 0x80; value >>= 7) { data.push_back(static_cast<char>((value & 0x7f) | 0x80)); }
+    data.push_back(static_cast<char>(value));
+}
+
+template<typename T>
+bool parseBatch(const char *data, size_t size, std::vector<T> &objs) {
+    objs.clear();
+    for (const char *cur = data, *end = data + size; cur != end;) {
+        unsigned long long len;
+        if (!readVarint(cur, end, len) || (len > static_cast<unsigned long long>(end - cur))) { return false; }
+        objs.emplace_back();
+        if (!binaryToProtobuf(cur, static_cast<size_t>(len), objs.back())) { return false; }
+        cur += len;
+    }
     return true;
 }
 
 template<typename T>
-static bool save(const std::string &path, const T &obj) {
-    std::ofstream ofs(path);
+static bool loadBatch(const std::string &path, std::vector<T> &objs) {
+    ck::MappedFile file(path);
+    return file.isOpen() && parseBatch(file.data(), file.size(), objs);
+}
+
+template<typename T>
+static bool saveBatch(const std::string &path, const std::vector<T> &objs) {
+    std::string data;
+    for (auto obj = objs.begin(); obj != objs.end(); ++obj) {
+        appendVarint(data, obj->ByteSizeLong());
+        obj->AppendToString(&data);
+    }
+    std::ofstream ofs(path, std::ios::binary);
     if (!ofs.is_open()) { return false; }
-    ofs << protobufToJson(obj);
+    ofs << data;
     return true;
 }
 
+template<typename T>
+static bool save(const std::string &path, const T &obj) {
+    std::ofstream ofs(path, std::ios::binary);
+    if (!ofs.is_open()) { return false; }
+    ofs << (isBinaryPath(path) ? protobufToBinary(obj) : protobufToJson(obj));
+    return true;
+}
 }
 
 
@@ -16,6 +16,7 @@
 
 #include "Common.h"
 #include "PbReader.h"
+#include "JsonWriter.h"
 #include "RectPacking.pb.h"
 
 
@@ -26,12 +27,13 @@ class Problem {
 public:
     struct Input : public pb::RectPacking::Input {
         bool load(const String &path) { return pb::load(path, *this); }
+        bool save(const String &path) const { return pb::save(path, *this); }
     };
 
     struct Output : public pb::RectPacking::Output {
+        bool load(const String &path) { return pb::loadWithHeader(path, *this); }
         bool save(const String &path, pb::Submission &submission) const {
-            std::ofstream ofs(path);
-            if (!ofs.is_open()) { return false; }
+            if (pb::isBinaryPath(path)) { return pb::save(path, *this); } // the submission is only kept in json.
 
             // TODO[0]: fill the submission information.
             submission.set_author("ck");
@@ -43,8 +45,11 @@ public:
             submission.set_os("Windows 10");
             submission.set_problem("RectPacking");
 
-            ofs << protobufToJson(submission, false) << std::endl << protobufToJson(*this);
-            return true;
+            pb::JsonWriter writer;
+            writer.write(submission);
+            writer.newLine();
+            writer.write(*this);
+            return writer.save(path);
         }
 
         //double useRatio = 0;
@@ -0,0 +1,198 @@
+////////////////////////////////
+/// usage : 1.	compact binary encoding of solutions for keeping all of them for auditing.
+///
+/// note  : 1.	a record is the header (magic, version, instance hash, side length, placement
+///             number, flags), the ids, xs and ys as zigzag varint deltas in the order of ids,
+///             and the rotations as a bitset. the ids are omitted if they are exactly 0 to n-1.
+///         2.	decoding restores the output with the placements sorted by id, which is
+///             the order the solver writes them in, so solutions of the solver round-trip exactly.
+///         3.	an archive file is a stream of records each of which is preceded by its size in a
+///             varint like batches, so new records can be appended without reading the others.
+////////////////////////////////
+
+#ifndef SMART_CK_RECT_PACKING_SOLUTION_ARCHIVE_H
+#define SMART_CK_RECT_PACKING_SOLUTION_ARCHIVE_H
+
+
+#include "Config.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include "Common.h"
+#include "MappedFile.h"
+#include "PbReader.h"
+#include "RectPacking.pb.h"
+
+
+namespace ck {
+
+class SolutionArchive {
+public:
+    using Hash = unsigned long long;
+
+    struct Record {
+        Hash instanceHash;
+        pb::RectPacking::Output output;
+    };
+
+
+    static constexpr char Version = 1;
+    static constexpr int HeaderSize = 4 + sizeof(Hash); // the magic, the version and the instance hash.
+
+    enum Flag { ConsecutiveIds = 0x1 };
+
+
+    static String Magic() { return "CKS"; }
+    static String HashListExtension() { return ".hash.csv"; } // the instance hashes of an extracted batch.
+
+
+    // 64-bit fnv-1a over the rectangles, which identifies the instance a solution belongs to.
+    static Hash instanceHash(const pb::RectPacking::Input &input) {
+        static constexpr Hash OffsetBasis = 14695981039346656037ull;
+        static constexpr Hash Prime = 1099511628211ull;
+        Hash h = OffsetBasis;
+        auto mix = [&](google::protobuf::int32 value) {
+            unsigned v = static_cast<unsigned>(value);
+            for (int i = 0; i < 4; ++i, v >>= 8) { h = (h ^ (v & 0xff)) * Prime; }
+        };
+        mix(input.rectangles().size());
+        for (auto r = input.rectangles().begin(); r != input.rectangles().end(); ++r) {
+            mix(r->id());
+            mix(r->width());
+            mix(r->height());
+        }
+        return h;
+    }
+
+    // append the encoded output to data.
+    static void encode(const pb::RectPacking::Output &output, Hash instHash, String &data) {
+        List<const pb::Placement*> placements;
+        placements.reserve(output.placements().size());
+        for (auto p = output.placements().begin(); p != output.placements().end(); ++p) { placements.push_back(&(*p)); }
+        std::stable_sort(placements.begin(), placements.end(), [](const pb::Placement *l, const pb::Placement *r) { return l->id() < r->id(); });
+
+        bool isConsecutive = true;
+        for (int i = 0; i < static_cast<int>(placements.size()); ++i) { isConsecutive &= (placements[i]->id() == i); }
+
+        data += Magic();
+        data.push_back(Version);
+        for (int i = 0; i < static_cast<int>(sizeof(Hash)); ++i) { data.push_back(static_cast<char>(instHash >> (8 * i))); }
+        appendSigned(data, output.length());
+        pb::appendVarint(data, placements.size());
+        data.push_back(static_cast<char>(isConsecutive ? Flag::ConsecutiveIds : 0));
+
+        if (!isConsecutive) { appendDeltas(data, placements, [](const pb::Placement *p) { return p->id(); }); }
+        appendDeltas(data, placements, [](const pb::Placement *p) { return p->x(); });
+        appendDeltas(data, placements, [](const pb::Placement *p) { return p->y(); });
+
+        for (size_t i = 0; i < placements.size(); i += 8) {
+            unsigned char bits = 0;
+            for (size_t b = 0; (b < 8) && (i + b < placements.size()); ++b) {
+                if (placements[i + b]->rotated()) { bits |= (1 << b); }
+            }
+            data.push_back(static_cast<char>(bits));
+        }
+    }
+
+    // return false if the record is broken.
+    static bool decode(const char *data, size_t size, pb::RectPacking::Output &output, Hash &instHash) {
+        const char *cur = data;
+        const char *end = data + size;
+        if ((size < HeaderSize) || (Magic().compare(0, 3, cur, 3) != 0) || (cur[3] != Version)) { return false; }
+        cur += 4;
+        instHash = 0;
+        for (int i = 0; i < static_cast<int>(sizeof(Hash)); ++i) { instHash |= static_cast<Hash>(static_cast<unsigned char>(*(cur++))) << (8 * i); }
+
+        long long length;
+        unsigned long long placementNum;
+        if (!readSigned(cur, end, length) || !pb::readVarint(cur, end, placementNum) || (cur == end)) { return false; }
+        if (placementNum > static_cast<unsigned long long>(end - cur)) { return false; } // every placement takes at least a byte.
+        int n = static_cast<int>(placementNum);
+        char flags = *(cur++);
+
+        output.Clear();
+        output.set_length(static_cast<google::protobuf::int32>(length));
+        auto &placements(*output.mutable_placements());
+        placements.Reserve(n);
+        for (int i = 0; i < n; ++i) { placements.Add()->set_id(i); }
+
+        if (!(flags & Flag::ConsecutiveIds) && !readDeltas(cur, end, placements, &pb::Placement::set_id)) { return false; }
+        if (!readDeltas(cur, end, placements, &pb::Placement::set_x)) { return false; }
+        if (!readDeltas(cur, end, placements, &pb::Placement::set_y)) { return false; }
+
+        if (end - cur != (n + 7) / 8) { return false; }
+        for (int i = 0; i < n; ++i) {
+            placements.Mutable(i)->set_rotated(((static_cast<unsigned char>(cur[i / 8]) >> (i % 8)) & 1) != 0);
+        }
+        return true;
+    }
+
+    // append the records to the archive file.
+    static bool append(const String &path, const List<String> &records) {
+        String data;
+        for (auto r = records.begin(); r != records.end(); ++r) {
+            pb::appendVarint(data, r->size());
+            data += *r;
+        }
+        std::ofstream ofs(path, std::ios::binary | std::ios::app);
+        if (!ofs.is_open()) { return false; }
+        ofs << data;
+        return true;
+    }
+
+    static bool load(const String &path, List<Record> &records) {
+        MappedFile file(path);
+        if (!file.isOpen()) { return false; }
+        records.clear();
+        for (const char *cur = file.data(), *end = file.data() + file.size(); cur != end;) {
+            unsigned long long len;
+            if (!pb::readVarint(cur, end, len) || (len > static_cast<unsigned long long>(end - cur))) { return false; }
+            records.emplace_back();
+            if (!decode(cur, static_cast<size_t>(len), records.back().output, records.back().instanceHash)) { return false; }
+            cur += len;
+        }
+        return true;
+    }
+
+protected:
+    static void appendSigned(String &data, long long value) { // zigzag maps small magnitudes to small codes.
+        pb::appendVarint(data, (static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63));
+    }
+
+    // the differences between consecutive values are small since the positions are bounded by the side length.
+    template<typename Get>
+    static void appendDeltas(String &data, const List<const pb::Placement*> &placements, Get get) {
+        long long last = 0;
+        for (auto p = placements.begin(); p != placements.end(); ++p) {
+            long long value = get(*p);
+            appendSigned(data, value - last);
+            last = value;
+        }
+    }
+
+    static bool readSigned(const char *&cur, const char *end, long long &value) {
+        unsigned long long code;
+        if (!pb::readVarint(cur, end, code)) { return false; }
+        value = static_cast<long long>(code >> 1) ^ -static_cast<long long>(code & 1);
+        return true;
+    }
+
+    using Setter = void (pb::Placement::*)(google::protobuf::int32);
+
+    static bool readDeltas(const char *&cur, const char *end, google::protobuf::RepeatedPtrField<pb::Placement> &placements, Setter set) {
+        long long value = 0;
+        for (auto p = placements.begin(); p != placements.end(); ++p) {
+            long long delta;
+            if (!readSigned(cur, end, delta)) { return false; }
+            value += delta;
+            ((*p).*set)(static_cast<google::protobuf::int32>(value));
+        }
+        return true;
+    }
+};
+
+}
+
+
+#endif // SMART_CK_RECT_PACKING_SOLUTION_ARCHIVE_H
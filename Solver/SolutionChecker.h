@@ -0,0 +1,111 @@
+////////////////////////////////
+/// usage : 1.	verify a solution of the rectangle packing problem in memory.
+///
+/// note  : 1.	the result is the same as the return code of the checker program, i.e., the side
+///             length if the solution is feasible, or the bitwise not of the error flags otherwise.
+///         2.	overlaps are found by sweeping over x with the active y intervals kept in
+///             a balanced tree, which takes O(n log n).
+////////////////////////////////
+
+#ifndef SMART_CK_RECT_PACKING_SOLUTION_CHECKER_H
+#define SMART_CK_RECT_PACKING_SOLUTION_CHECKER_H
+
+
+#include "Config.h"
+
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "RectPacking.pb.h"
+
+
+namespace ck {
+
+class SolutionChecker {
+public:
+    enum CheckerFlag {
+        IoError = 0x0,
+        FormatError = 0x1,
+        CoordinateOverError = 0x2,
+        RectangleOverlapError = 0x4,
+    };
+
+
+    // error may carry the flags found before, e.g., a format error from parsing the solution file.
+    static int check(const pb::RectPacking::Input &input, const pb::RectPacking::Output &output, int error = 0) {
+        int bufferEdge = output.length();
+        if (output.placements().size() != input.rectangles().size()) { error |= CheckerFlag::FormatError; }
+        std::vector<Box> boxes;
+        boxes.reserve(output.placements().size());
+        for (auto p = output.placements().begin(); p != output.placements().end(); ++p) {
+            if ((p->id() < 0) || (p->id() >= input.rectangles().size())) {
+                error |= CheckerFlag::FormatError;
+                continue;
+            }
+            int width = input.rectangles(p->id()).width();
+            int height = input.rectangles(p->id()).height();
+            if (p->rotated()) { std::swap(width, height); }
+            int x = p->x(), y = p->y();
+            if ((x > bufferEdge) || (y > bufferEdge) || (x < 0) || (y < 0)
+                || (x + width > bufferEdge) || (y + height > bufferEdge)) { // every rectangle must be inside the square.
+                error |= CheckerFlag::CoordinateOverError;
+            }
+            boxes.push_back({ x, y, x + width, y + height });
+        }
+        if (isOverlapped(boxes)) { error |= CheckerFlag::RectangleOverlapError; }
+        return (error == 0) ? output.length() : ~error;
+    }
+
+protected:
+    struct Box {
+        int x0;
+        int y0;
+        int x1;
+        int y1;
+    };
+
+
+    // the active intervals are disjoint until the first overlap is found, so checking
+    // the neighbors of each new interval is enough.
+    static bool isOverlapped(const std::vector<Box> &boxes) {
+        struct Event {
+            int x;
+            bool isBegin;
+            int box;
+
+            // end events go first so that touching rectangles are not overlapped.
+            bool operator<(const Event &e) const { return (x != e.x) ? (x < e.x) : (isBegin < e.isBegin); }
+        };
+
+        std::vector<Event> events;
+        events.reserve(boxes.size() * 2);
+        for (int i = 0; i < static_cast<int>(boxes.size()); ++i) {
+            if ((boxes[i].x0 >= boxes[i].x1) || (boxes[i].y0 >= boxes[i].y1)) { continue; } // zero area.
+            events.push_back({ boxes[i].x0, true, i });
+            events.push_back({ boxes[i].x1, false, i });
+        }
+        std::sort(events.begin(), events.end());
+
+        std::set<std::pair<int, int>> active; // (y0, box).
+        for (auto e = events.begin(); e != events.end(); ++e) {
+            const Box &b(boxes[e->box]);
+            if (!e->isBegin) {
+                active.erase({ b.y0, e->box });
+                continue;
+            }
+            auto next = active.lower_bound({ b.y0, -1 });
+            if ((next != active.end()) && (next->first < b.y1)) { return true; }
+            if ((next != active.begin()) && (boxes[std::prev(next)->second].y1 > b.y0)) { return true; }
+            active.insert(next, { b.y0, e->box });
+        }
+        return false;
+    }
+};
+
+}
+
+
+#endif // SMART_CK_RECT_PACKING_SOLUTION_CHECKER_H
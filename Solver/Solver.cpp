@@ -1,6 +1,7 @@
 #include "Solver.h"
 
 #include <algorithm>
+#include <iomanip>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -30,7 +31,8 @@ int Solver::Cli::run(int argc, char * argv[]) {
         { RunIdOption(), nullptr },
         { EnvironmentPathOption(), nullptr },
         { ConfigPathOption(), nullptr },
-        { LogPathOption(), nullptr }
+        { LogPathOption(), nullptr },
+        { AffinityOption(), nullptr }
     });
 
     for (int i = 1; i < argc; ++i) { // skip executable name.
@@ -55,8 +57,22 @@ int Solver::Cli::run(int argc, char * argv[]) {
     env.load(optionMap);
     if (env.instPath.empty() || env.slnPath.empty()) { return -1; }
 
+    bool isBatch = (switchSet.find(BatchSwitch()) != switchSet.end());
+    bool isConvert = (switchSet.find(ConvertSwitch()) != switchSet.end());
+    if (switchSet.find(ArchiveSwitch()) != switchSet.end()) { // keep solutions for auditing.
+        return isConvert ? extractArchive(env) : archive(env);
+    }
+    if (isConvert) { // e.g., move instances from json to binary.
+        if (isBatch) { return convertBatch(env); }
+        Log(LogSwitch::Ck::Input) << "convert instance " << env.instPath << " to " << env.slnPath << "." << endl;
+        Problem::Input input;
+        return (input.load(env.instPath) && input.save(env.slnPath)) ? 0 : -1;
+    }
+
     Solver::Configuration cfg;
     cfg.load(env.cfgPath);
+    if (switchSet.find(DeterministicSwitch()) != switchSet.end()) { cfg.deterministic = true; }
+    if (isBatch) { return runBatch(env, cfg); }
 
     Log(LogSwitch::Ck::Input) << "load instance " << env.instPath << " (seed=" << env.randSeed << ")." << endl;
     Problem::Input input;
@@ -78,62 +94,178 @@ int Solver::Cli::run(int argc, char * argv[]) {
 
     return 0;
 }
+
+int Solver::Cli::runBatch(const Environment &env, const Configuration &cfg) {
+    Log(LogSwitch::Ck::Input) << "load instance batch " << env.instPath << " (seed=" << env.randSeed << ")." << endl;
+    List<Problem::Input> inputs;
+    if (!pb::loadBatch(env.instPath, inputs)) { return -1; }
+
+    ThreadPool<> pool(env.jobNum); // launched once for all instances. no solver uses more workers than env.jobNum.
+    List<Problem::Output> outputs(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        Solver solver(inputs[i], env, cfg, &pool); // the timer starts here, so each instance gets the whole timeout.
+        solver.solve();
+        #if CK_DEBUG
+        solver.record(); // one log row per instance, which also checks the solution.
+        #endif // CK_DEBUG
+        outputs[i].Swap(&solver.output);
+        Log(LogSwitch::Ck::Output) << "instance " << i << " got " << outputs[i].length() << "." << endl;
+    }
+
+    return pb::saveBatch(env.slnPath, outputs) ? 0 : -1;
+}
+
+int Solver::Cli::convertBatch(const Environment &env) {
+    Log(LogSwitch::Ck::Input) << "pack instances listed in " << env.instPath << " into batch " << env.slnPath << "." << endl;
+    ifstream ifs(env.instPath);
+    if (!ifs.is_open()) { return -1; }
+
+    List<Problem::Input> inputs;
+    for (String path; getline(ifs, path);) {
+        if (!path.empty() && (path.back() == '\r')) { path.pop_back(); }
+        if (path.empty()) { continue; }
+        inputs.emplace_back();
+        if (!inputs.back().load(path)) { return -1; }
+    }
+
+    return pb::saveBatch(env.slnPath, inputs) ? 0 : -1;
+}
+
+int Solver::Cli::archive(const Environment &env) {
+    Log(LogSwitch::Ck::Output) << "archive solutions listed in " << env.instPath << " into " << env.slnPath << "." << endl;
+    CsvReader reader;
+    const List<CsvReader::Row> &rows(reader.scan(env.instPath));
+
+    List<String> records;
+    records.reserve(rows.size());
+    for (auto r = rows.begin(); r != rows.end(); ++r) {
+        if (r->size() < 2) { continue; }
+        Problem::Input input;
+        Problem::Output output;
+        if (!input.load((*r)[0]) || !output.load((*r)[1])) {
+            Log(LogSwitch::Ck::Output) << "fail to load " << (*r)[0] << " or " << (*r)[1] << "." << endl;
+            return -1;
+        }
+        records.emplace_back();
+        SolutionArchive::encode(output, SolutionArchive::instanceHash(input), records.back());
+    }
+
+    return SolutionArchive::append(env.slnPath, records) ? 0 : -1;
+}
+
+int Solver::Cli::extractArchive(const Environment &env) {
+    Log(LogSwitch::Ck::Output) << "extract solutions in archive " << env.instPath << " into batch " << env.slnPath << "." << endl;
+    List<SolutionArchive::Record> records;
+    if (!SolutionArchive::load(env.instPath, records)) { return -1; }
+
+    // the instance hashes are saved next to the batch in the same order, so the solutions can still be tied to their instances.
+    String hashPath(env.slnPath + SolutionArchive::HashListExtension());
+    ofstream ofs(hashPath);
+    if (!ofs.is_open()) { return -1; }
+    List<pb::RectPacking::Output> outputs(records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        ofs << i << CsvReader::CommaChar << hex << setw(16) << setfill('0') << records[i].instanceHash << dec << '\n';
+        outputs[i].Swap(&records[i].output);
+    }
+    ofs.close();
+    if (!ofs) { return -1; }
+    return pb::saveBatch(env.slnPath, outputs) ? 0 : -1;
+}
 #pragma endregion Solver::Cli
 
 #pragma region Solver::Environment
 void Solver::Environment::load(const Map<String, char*> &optionMap) {
-    char *str;
-
-    str = optionMap.at(Cli::EnvironmentPathOption());
+    char *str = optionMap.at(Cli::EnvironmentPathOption());
     if (str != nullptr) { loadWithoutCalibrate(str); }
 
-    str = optionMap.at(Cli::InstancePathOption());
+    loadOptions(optionMap);
+
+    calibrate();
+}
+
+void Solver::Environment::load(const String &filePath) {
+    loadWithoutCalibrate(filePath);
+    calibrate();
+}
+
+void Solver::Environment::loadWithoutCalibrate(const String &filePath) {
+    if (filePath.empty()) { return; } // not specified.
+
+    CsvReader reader;
+    const List<CsvReader::Row> &rows(reader.scan(filePath)); // empty if the file does not exist.
+    if (rows.empty()) { Log(LogSwitch::Ck::Input) << "no environment is loaded from " << filePath << "." << endl; }
+
+    Map<String, char*> optionMap;
+    for (auto r = rows.begin(); r != rows.end(); ++r) {
+        if ((r->size() >= 2) && (*(*r)[1] != '\0')) { optionMap[r->front()] = (*r)[1]; } // empty values are the defaults.
+    }
+    loadOptions(optionMap);
+}
+
+void Solver::Environment::loadOptions(const Map<String, char*> &optionMap) {
+    auto option = [&](const String &key) -> char* { // the options may be absent in files.
+        auto o = optionMap.find(key);
+        return (o != optionMap.end()) ? o->second : nullptr;
+    };
+    char *str;
+
+    str = option(Cli::InstancePathOption());
     if (str != nullptr) { instPath = str; }
 
-    str = optionMap.at(Cli::SolutionPathOption());
+    str = option(Cli::SolutionPathOption());
     if (str != nullptr) { slnPath = str; }
 
-    str = optionMap.at(Cli::RandSeedOption());
+    str = option(Cli::RandSeedOption());
     if (str != nullptr) { randSeed = atoi(str); }
 
-    str = optionMap.at(Cli::TimeoutOption());
+    str = option(Cli::TimeoutOption());
     if (str != nullptr) { msTimeout = static_cast<Duration>(atof(str) * Timer::MillisecondsPerSecond); }
 
-    str = optionMap.at(Cli::MaxIterOption());
+    str = option(Cli::MaxIterOption());
     if (str != nullptr) { maxIter = atoi(str); }
 
-    str = optionMap.at(Cli::JobNumOption());
+    str = option(Cli::JobNumOption());
     if (str != nullptr) { jobNum = atoi(str); }
 
-    str = optionMap.at(Cli::RunIdOption());
+    str = option(Cli::RunIdOption());
     if (str != nullptr) { rid = str; }
 
-    str = optionMap.at(Cli::ConfigPathOption());
+    str = option(Cli::ConfigPathOption());
     if (str != nullptr) { cfgPath = str; }
 
-    str = optionMap.at(Cli::LogPathOption());
+    str = option(Cli::LogPathOption());
     if (str != nullptr) { logPath = str; }
 
-    calibrate();
-}
-
-void Solver::Environment::load(const String &filePath) {
-    loadWithoutCalibrate(filePath);
-    calibrate();
-}
-
-void Solver::Environment::loadWithoutCalibrate(const String &filePath) {
-    // EXTEND[ck][8]: load environment from file.
-    // EXTEND[ck][8]: check file existence first.
+    str = option(Cli::AffinityOption());
+    if (str != nullptr) { affinity = str; }
 }
 
 void Solver::Environment::save(const String &filePath) const {
-    // EXTEND[ck][8]: save environment to file.
+    ofstream ofs(filePath);
+    if (!ofs.is_open()) { return; }
+    const char c = CsvReader::CommaChar;
+    ofs << Cli::InstancePathOption() << c << instPath << '\n'
+        << Cli::SolutionPathOption() << c << slnPath << '\n'
+        << Cli::RandSeedOption() << c << randSeed << '\n'
+        << Cli::TimeoutOption() << c << (static_cast<double>(msTimeout) / Timer::MillisecondsPerSecond) << '\n'
+        << Cli::MaxIterOption() << c << maxIter << '\n'
+        << Cli::JobNumOption() << c << jobNum << '\n'
+        << Cli::RunIdOption() << c << rid << '\n'
+        << Cli::ConfigPathOption() << c << cfgPath << '\n'
+        << Cli::LogPathOption() << c << logPath << '\n'
+        << Cli::AffinityOption() << c << affinity << '\n';
 }
 void Solver::Environment::calibrate() {
-    // adjust thread number.
-    int threadNum = thread::hardware_concurrency();
+    // adjust thread number to the cpus which are really available in containers.
+    int hardwareThreadNum = thread::hardware_concurrency();
+    int affinityThreadNum = static_cast<int>(System::availableCpus().size()); // cpuset or taskset.
+    double quota = System::cpuQuota(); // cgroup cpu bandwidth limit.
+    int threadNum = (max)(1, (min)(hardwareThreadNum, affinityThreadNum));
+    if (quota > 0) { threadNum = (max)(1, (min)(threadNum, static_cast<int>(Math::lfloor(quota)))); } // avoid being throttled.
+    int requestedJobNum = jobNum;
     if ((jobNum <= 0) || (jobNum > threadNum)) { jobNum = threadNum; }
+    Log(LogSwitch::Ck::Framework) << "calibrate job number to " << jobNum << " (requested=" << requestedJobNum
+        << ", hardware=" << hardwareThreadNum << ", affinity=" << affinityThreadNum << ", quota=" << quota << ")." << endl;
 
     // adjust timeout.
     msTimeout -= Environment::SaveSolutionTimeInMillisecond;
@@ -142,12 +274,35 @@ void Solver::Environment::calibrate() {
 
 #pragma region Solver::Configuration
 void Solver::Configuration::load(const String &filePath) {
-    // EXTEND[ck][5]: load configuration from file.
-    // EXTEND[ck][8]: check file existence first.
+    if (filePath.empty()) { return; } // not specified.
+
+    CsvReader reader;
+    const List<CsvReader::Row> &rows(reader.scan(filePath)); // empty if the file does not exist.
+    if (rows.empty()) { Log(LogSwitch::Ck::Input) << "no configuration is loaded from " << filePath << "." << endl; }
+
+    for (auto r = rows.begin(); r != rows.end(); ++r) {
+        if ((r->size() < 2) || (*(*r)[1] == '\0')) { continue; } // empty values are the defaults.
+        String key(r->front());
+        char *value = (*r)[1];
+        if (key == AlgorithmKey()) {
+            alg = static_cast<Algorithm>(atoi(value));
+        } else if (key == ThreadNumKey()) {
+            threadNumPerWorker = atoi(value);
+        } else if (key == DeterministicKey()) {
+            deterministic = (atoi(value) != 0);
+        } else {
+            Log(LogSwitch::Ck::Input) << "unknown configuration " << key << "." << endl;
+        }
+    }
 }
 
 void Solver::Configuration::save(const String &filePath) const {
-    // EXTEND[ck][5]: save configuration to file.
+    ofstream ofs(filePath);
+    if (!ofs.is_open()) { return; }
+    const char c = CsvReader::CommaChar;
+    ofs << AlgorithmKey() << c << alg << '\n'
+        << ThreadNumKey() << c << threadNumPerWorker << '\n'
+        << DeterministicKey() << c << deterministic << '\n';
 }
 #pragma endregion Solver::Configuration
 
@@ -155,41 +310,93 @@ void Solver::Configuration::save(const String &filePath) const {
 bool Solver::solve() {
     init();
 
+    cfg.threadNumPerWorker = Math::bound(cfg.threadNumPerWorker, 1, env.jobNum); // env.jobNum has been calibrated to the available cpus.
     int workerNum = (max)(1, env.jobNum / cfg.threadNumPerWorker);
     cfg.threadNumPerWorker = env.jobNum / workerNum;
+    Log(LogSwitch::Ck::Framework) << "use " << workerNum << " workers with " << cfg.threadNumPerWorker << " threads each." << endl;
     List<Solution> solutions(workerNum, Solution(this));
-    List<bool> success(workerNum);
+    List<char> success(workerNum, false); // not List<bool> whose bits share words written by different workers.
+    aux.workerNum = workerNum;
+    islandStats.assign(workerNum, IslandStat());
+    syncPoint.reset(workerNum);
+    migrationChannels.clear();
+    if (cfg.alg == Configuration::Algorithm::Genetic) { // a ring of islands.
+        for (int i = 0; i < workerNum; ++i) { migrationChannels.emplace_back(new SpscQueue<Chromosome>(MigrationChannelCapacity)); }
+    }
+
+    workerCpus = placeWorkers(workerNum);
+    if (!workerCpus.empty()) {
+        Log(LogSwitch::Ck::Framework) << "pin workers to cpus";
+        for (auto c = workerCpus.begin(); c != workerCpus.end(); ++c) { Log(LogSwitch::Ck::Framework) << " " << *c; }
+        Log(LogSwitch::Ck::Framework) << " (" << env.affinity << ")." << endl;
+    }
 
     Log(LogSwitch::Ck::Framework) << "launch " << workerNum << " workers." << endl;
-    List<thread> threadList;
-    threadList.reserve(workerNum);
+    unique_ptr<ThreadPool<>> ownPool;
+    if ((workerPool == nullptr) || (workerPool->threadNum() < workerNum)) { // workers never wait for each other, so each of them needs its own thread.
+        ownPool.reset(new ThreadPool<>(workerNum));
+    }
+    TaskGroup<ThreadPool<>> workers(ownPool ? *ownPool : *workerPool);
     for (int i = 0; i < workerNum; ++i) {
         // TODO[ck][2]: as *this is captured by ref, the solver should support concurrency itself, i.e., data members should be read-only or independent for each worker.
         // OPTIMIZE[ck][3]: add a list to specify a series of algorithm to be used by each threads in sequence.
-        threadList.emplace_back([&, i]() { success[i] = optimize(solutions[i], i); });
+        workers.run([&, i]() {
+            if (!workerCpus.empty() && !System::bindThreadToCpu(workerCpus[i])) {
+                Log(LogSwitch::Ck::Framework) << "fail to pin worker " << i << " to cpu " << workerCpus[i] << "." << endl;
+            }
+            // the worker state is allocated inside optimize() after pinning, so it is placed on the local numa node by first touch.
+            success[i] = optimize(solutions[i], i);
+        });
     }
-    for (int i = 0; i < workerNum; ++i) { threadList.at(i).join(); }
+    workers.wait();
 
     Log(LogSwitch::Ck::Framework) << "collect best result among all workers." << endl;
-    int bestIndex = -1;
-    int minLength = 999;
     for (int i = 0; i < workerNum; ++i) {
         if (!success[i]) { continue; }
         Log(LogSwitch::Ck::Framework) << "worker " << i << " got " << solutions[i].length()<< endl;
-        if (solutions[i].length()  > minLength) { continue; }
-        bestIndex = i;
-        minLength = solutions[i].length();
     }
 
-    env.rid = to_string(bestIndex);
-    if (bestIndex < 0) { return false; }
-    output = solutions[bestIndex];
+    if (!cfg.deterministic && incumbent.read(output)) { // every worker has published its best complete solution.
+        env.rid = to_string(incumbent.owner());
+        return true;
+    }
+
+    // break ties by the worker id instead of the order of publishing.
+    // complete solutions go first, but the best partial one is still emitted if no worker completes.
+    auto pickBest = [&](bool isCompleteOnly) {
+        int best = -1;
+        for (int i = 0; i < workerNum; ++i) {
+            if (!success[i]) { continue; }
+            if (isCompleteOnly && (solutions[i].placements().size() != input.rectangles().size())) { continue; }
+            if ((best < 0) || (solutions[i].length() < solutions[best].length())) { best = i; }
+        }
+        return best;
+    };
+    int best = pickBest(true);
+    if (best < 0) { best = pickBest(false); }
+    env.rid = to_string(best);
+    if (best < 0) { return false; }
+    output = solutions[best];
     return true;
 }
 
 void Solver::record() const {
     #if CK_DEBUG
     int generation = 0;
+    ostringstream islands;
+    for (int i = 0; i < static_cast<int>(islandStats.size()); ++i) {
+        const IslandStat &stat(islandStats[i]);
+        if (stat.generation <= 0) { continue; }
+        generation += stat.generation;
+        islands << i << ":" << stat.generation << "/" << stat.diversity << "/" << stat.acceptedMigrantNum << "/" << stat.migrantNum << " ";
+    }
+
+    ostringstream affinity;
+    if (!workerCpus.empty()) {
+        bool isPolicy = (env.affinity == Environment::CompactAffinity()) || (env.affinity == Environment::ScatterAffinity());
+        affinity << (isPolicy ? env.affinity : "list") << ":"; // an explicit list contains commas.
+        for (auto c = workerCpus.begin(); c != workerCpus.end(); ++c) { affinity << " " << *c; }
+    }
 
     ostringstream log;
 
@@ -209,11 +416,11 @@ void Solver::record() const {
 		<< mu.physicalMemory << "," << mu.virtualMemory << ","
 		<< env.randSeed << ","
 		<< cfg.toBriefStr() << ","
-		<< generation << "," << iteration;
+		<< generation << "," << iteration << ",";
 
     // record solution vector.
     // EXTEND[ck][2]: save solution in log.
-    log << endl;
+    log << "," << "," << islands.str() << "," << affinity.str() << endl;
 
     // append all text atomically.
     static mutex logFileMutex;
@@ -222,7 +429,7 @@ void Solver::record() const {
     ofstream logFile(env.logPath, ios::app);
     logFile.seekp(0, ios::end);
     if (logFile.tellp() <= 0) {
-        logFile << "Time,ID,Instance,Feasible,ObjMatch,Width,Duration,PhysMem,VirtMem,RandSeed,Config,Generation,Iteration,Ratio,Solution" << endl;
+        logFile << "Time,ID,Instance,Feasible,ObjMatch,Width,Duration,PhysMem,VirtMem,RandSeed,Config,Generation,Iteration,Ratio,Solution,Islands,Affinity" << endl;
     }
     logFile << log.str();
     logFile.close();
@@ -231,22 +438,15 @@ void Solver::record() const {
 
 bool Solver::check(Length &checkerObj) const {
     #if CK_DEBUG
-    enum CheckerFlag {
-		IoError = 0x0,
-		FormatError = 0x1,
-		CoordinateOverError = 0x2,
-		RectangleOverlapError = 0x4,
-		LackingRectanglesError = 0x8
-    };
+    using CheckerFlag = SolutionChecker::CheckerFlag;
 
-    checkerObj = System::exec("Checker.exe " + env.instPath + " " + env.solutionPathWithTime());
+    checkerObj = SolutionChecker::check(input, output); // the same as running the checker on the saved solution.
     if (checkerObj > 0) { return true; }
     checkerObj = ~checkerObj;
     if (checkerObj == CheckerFlag::IoError) { Log(LogSwitch::Checker) << "IoError." << endl; }
     if (checkerObj & CheckerFlag::FormatError) { Log(LogSwitch::Checker) << "FormatError." << endl; }
     if (checkerObj & CheckerFlag::CoordinateOverError) { Log(LogSwitch::Checker) << "CoordinateOverError." << endl; }
     if (checkerObj & CheckerFlag::RectangleOverlapError) { Log(LogSwitch::Checker) << "RectangleOverlapError." << endl; }
-	if (checkerObj & CheckerFlag::LackingRectanglesError) { Log(LogSwitch::Checker) << "LackingRectanglesError" << endl; }
     return false;
     #else
     checkerObj = 0;
@@ -255,34 +455,390 @@ bool Solver::check(Length &checkerObj) const {
 }
 
 void Solver::init() {
-
+    incumbent.reset(input.rectangles().size());
+
+    // the square must hold the total area and the longer side of every rectangle in either orientation.
+    long long area = 0;
+    aux.lowerBound = 0;
+    for (auto r = input.rectangles().begin(); r != input.rectangles().end(); ++r) {
+        area += static_cast<long long>(r->width()) * r->height();
+        aux.lowerBound = (max)(aux.lowerBound, (max)(r->width(), r->height()));
+    }
+    Length side = static_cast<Length>(sqrt(static_cast<double>(area)));
+    while (static_cast<long long>(side) * side < area) { ++side; }
+    aux.lowerBound = (max)(aux.lowerBound, side);
 }
 
 bool Solver::optimize(Solution &sln, ID workerId) {
 	Log(LogSwitch::Ck::Framework) << "worker " << workerId << " starts." << endl;
-	Random rand;
-	int rectangleNum = input.rectangles().size();
+	Random rand(Random::deriveSeed(env.randSeed, workerId)); // independent and reproducible streams for the workers.
 	bool status = true;
-	int maxLength = 0;
+
+	switch (cfg.alg) {
+	case Configuration::Algorithm::Greedy:
+		if (aux.workerNum > 1) {
+			status = optimizeProbing(sln, rand, workerId);
+		} else {
+			status = (cfg.threadNumPerWorker > 1) ? optimizeBottomLeftInParallel(sln, rand, workerId) : optimizeBottomLeft(sln, rand, workerId);
+		}
+		break;
+	case Configuration::Algorithm::Genetic:
+		status = optimizeGenetic(sln, rand, workerId); break;
+	default:
+		status = optimizeRandomly(sln, rand); break;
+	}
+	if (status) { incumbent.publish(sln, workerId); }
+	if (cfg.deterministic) { syncPoint.leave(status ? sln.length() : SyncPoint::NoValue); }
+
+	Log(LogSwitch::Ck::Framework) << "worker " << workerId << " ends." << endl;
+	return status;
+}
+
+bool Solver::optimizeBottomLeft(Solution &sln, Random &rand, ID workerId) {
+	BottomLeftDecoder decoder(input);
+	List<ID> order(decoder.defaultOrder());
+	if (!decoder.decode(order)) { return false; }
+	decoder.toOutput(sln);
+	Length bestLength = decoder.side();
+	incumbent.publish(sln, workerId);
+
+	// swap two rectangles in the sequence and accept it if the packing does not get worse.
+	int rectangleNum = static_cast<int>(order.size());
+	if (rectangleNum < 2) { return true; }
+	List<ID> neighbor(order);
+	Length knownLength = BottomLeftDecoder::NoBound;
+	for (Iteration iter = 0; !timer.isTimeOut() && (iter < env.maxIter); ++iter) {
+		int i = rand.pick(rectangleNum);
+		int j = rand.pick(rectangleNum - 1);
+		if (j >= i) { ++j; }
+		swap(neighbor[i], neighbor[j]);
+		// exceeding the best side length of this worker or any other worker fails fast.
+		if (decoder.decode(neighbor, (min)(bestLength, sharedLength(iter, bestLength, knownLength)))) {
+			order = neighbor;
+			if (decoder.side() < bestLength) {
+				bestLength = decoder.side();
+				decoder.toOutput(sln);
+				incumbent.publish(sln, workerId);
+				Log(LogSwitch::Ck::Model) << "iter " << iter << " improves to " << bestLength << endl;
+			}
+		} else {
+			swap(neighbor[i], neighbor[j]);
+		}
+	}
+	return true;
+}
+
+bool Solver::optimizeBottomLeftInParallel(Solution &sln, Random &rand, ID workerId) {
+	struct Move {
+		int i;
+		int j;
+		Length side; // NoBound if the neighbor is rejected.
+	};
+
+	HelperTeam team(cfg.threadNumPerWorker);
+	List<BottomLeftDecoder> decoders; // decoders[t] is the scratch space of thread t.
+	decoders.reserve(team.threadNum());
+	for (int t = 0; t < team.threadNum(); ++t) { decoders.emplace_back(input); }
+	List<List<ID>> neighbors(team.threadNum());
+	BottomLeftDecoder &decoder(decoders[0]); // also used by the owner between batches.
+
+	List<ID> order(decoder.defaultOrder());
+	if (!decoder.decode(order)) { return false; }
+	decoder.toOutput(sln);
+	Length bestLength = decoder.side();
+	incumbent.publish(sln, workerId);
+
+	int rectangleNum = static_cast<int>(order.size());
+	if (rectangleNum < 2) { return true; }
+	int moveNum = MoveNumPerThread * team.threadNum();
+	List<Move> moves(moveNum);
+	Length bound = bestLength;
+	HelperTeam::Task evaluate = [&](int m, int t) {
+		List<ID> &neighbor(neighbors[t]);
+		neighbor = order;
+		swap(neighbor[moves[m].i], neighbor[moves[m].j]);
+		moves[m].side = decoders[t].decode(neighbor, bound) ? decoders[t].side() : BottomLeftDecoder::NoBound;
+	};
+
+	List<ID> neighbor(order);
+	List<bool> isTouched(rectangleNum);
+	Length knownLength = BottomLeftDecoder::NoBound;
+	for (Iteration iter = 0, batch = 0; !timer.isTimeOut() && (iter < env.maxIter); iter += moveNum, ++batch) {
+		// the moves are sampled by the owner so that the trajectory does not depend on the scheduling.
+		for (auto m = moves.begin(); m != moves.end(); ++m) {
+			m->i = rand.pick(rectangleNum);
+			m->j = rand.pick(rectangleNum - 1);
+			if (m->j >= m->i) { ++m->j; }
+		}
+		bound = (min)(bestLength, sharedLength(batch, bestLength, knownLength));
+		team.run(moveNum, evaluate);
+
+		// apply the best move and then the other accepted moves which touch different positions.
+		stable_sort(moves.begin(), moves.end(), [](const Move &l, const Move &r) { return (l.side < r.side); });
+		if (moves.front().side >= BottomLeftDecoder::NoBound) { continue; }
+		neighbor = order;
+		fill(isTouched.begin(), isTouched.end(), false);
+		int appliedNum = 0;
+		for (auto m = moves.begin(); (m != moves.end()) && (m->side < BottomLeftDecoder::NoBound); ++m) {
+			if (isTouched[m->i] || isTouched[m->j]) { continue; }
+			isTouched[m->i] = isTouched[m->j] = true;
+			swap(neighbor[m->i], neighbor[m->j]);
+			++appliedNum;
+		}
+		// the combination has not been evaluated, so fall back to the best move if it turns out worse.
+		if (!decoder.decode(neighbor, moves.front().side)) {
+			neighbor = order;
+			swap(neighbor[moves.front().i], neighbor[moves.front().j]);
+			decoder.decode(neighbor, bound);
+			appliedNum = 1;
+		}
+		order.swap(neighbor);
+		if (decoder.side() < bestLength) {
+			bestLength = decoder.side();
+			decoder.toOutput(sln);
+			incumbent.publish(sln, workerId);
+			Log(LogSwitch::Ck::Model) << "iter " << iter << " improves to " << bestLength << " by " << appliedNum << " moves" << endl;
+		}
+	}
+	return true;
+}
+
+bool Solver::optimizeProbing(Solution &sln, Random &rand, ID workerId) {
+	BottomLeftDecoder decoder(input);
+	List<ID> order(decoder.defaultOrder());
+	if (!decoder.decode(order)) { return false; }
+	decoder.toOutput(sln);
+	incumbent.publish(sln, workerId);
+
+	int rectangleNum = static_cast<int>(order.size());
+	if (rectangleNum < 2) { return true; }
+	Length target = BottomLeftDecoder::NoBound; // the side of the square being probed.
+	int progress = 0; // number of rectangles the current sequence fits into the probed square.
+	Length provenLength = decoder.side(); // the best side length proven by this worker.
+	Length knownLength = BottomLeftDecoder::NoBound;
+	List<ID> neighbor(order);
+	for (Iteration iter = 0; !timer.isTimeOut() && (iter < env.maxIter); ++iter) {
+		Length upperBound = sharedLength(iter, provenLength, knownLength);
+		if (upperBound <= aux.lowerBound) { break; } // optimal.
+		if (target >= upperBound) { // some worker has proven a side no longer than the target feasible.
+			target = probeTarget(upperBound, workerId); // move on with the current sequence as the partial state.
+			Log(LogSwitch::Ck::Model) << "worker " << workerId << " probes " << target << endl;
+			neighbor = order;
+			progress = decoder.decode(order, target) ? rectangleNum : decoder.placedNum();
+			if (progress >= rectangleNum) {
+				decoder.toOutput(sln);
+				incumbent.publish(sln, workerId);
+				provenLength = (min)(provenLength, decoder.side());
+				continue;
+			}
+		}
+
+		int i = rand.pick(rectangleNum);
+		int j = rand.pick(rectangleNum - 1);
+		if (j >= i) { ++j; }
+		swap(neighbor[i], neighbor[j]);
+		if (decoder.decode(neighbor, target)) {
+			order = neighbor;
+			decoder.toOutput(sln);
+			incumbent.publish(sln, workerId);
+			provenLength = (min)(provenLength, decoder.side());
+			Log(LogSwitch::Ck::Model) << "worker " << workerId << " proves " << decoder.side() << endl;
+		} else if (decoder.placedNum() >= progress) { // fit no less rectangles into the square.
+			order = neighbor;
+			progress = decoder.placedNum();
+		} else {
+			swap(neighbor[i], neighbor[j]);
+		}
+	}
+	return true;
+}
+
+Length Solver::probeTarget(Length upperBound, ID workerId) const {
+	// spread the workers over [lowerBound, upperBound) from the safest to the most aggressive side.
+	Length span = (max)(upperBound - 1 - aux.lowerBound, 0);
+	return upperBound - 1 - static_cast<Length>(static_cast<long long>(span) * workerId / aux.workerNum);
+}
+
+Length Solver::sharedLength(Iteration iter, Length localBest, Length &knownLength) {
+	if (!cfg.deterministic) { return incumbent.length(); }
+	// the pruning must not depend on how fast the other workers are, so the bound only changes every SyncInterval iterations.
+	if ((iter % SyncInterval) == 0) { knownLength = syncPoint.arrive(localBest); }
+	return knownLength;
+}
+
+List<int> Solver::placeWorkers(int workerNum) const {
+	List<int> cpus;
+	if (env.affinity.empty()) { return cpus; }
+
+	if ((env.affinity == Environment::CompactAffinity()) || (env.affinity == Environment::ScatterAffinity())) {
+		List<System::Cpu> available(System::availableCpus());
+		sort(available.begin(), available.end(), [](const System::Cpu &l, const System::Cpu &r) {
+			if (l.package != r.package) { return (l.package < r.package); }
+			return (l.core != r.core) ? (l.core < r.core) : (l.id < r.id);
+		});
+		if (env.affinity == Environment::ScatterAffinity()) {
+			// rank the hyperthreads in each core and the cores in each socket, then take the first hyperthread
+			// of the first core of each socket, the first hyperthread of the second core of each socket and so on.
+			struct Rank { int sibling; int core; };
+			List<Rank> ranks(available.size());
+			for (size_t i = 0, coreRank = 0, siblingRank = 0; i < available.size(); ++i) {
+				if ((i > 0) && (available[i].package != available[i - 1].package)) {
+					coreRank = 0;
+					siblingRank = 0;
+				} else if ((i > 0) && (available[i].core != available[i - 1].core)) {
+					++coreRank;
+					siblingRank = 0;
+				} else if (i > 0) {
+					++siblingRank;
+				}
+				ranks[i] = { static_cast<int>(siblingRank), static_cast<int>(coreRank) };
+			}
+			List<int> order(available.size());
+			for (int i = 0; i < static_cast<int>(order.size()); ++i) { order[i] = i; }
+			stable_sort(order.begin(), order.end(), [&](int l, int r) {
+				if (ranks[l].sibling != ranks[r].sibling) { return (ranks[l].sibling < ranks[r].sibling); }
+				return (ranks[l].core < ranks[r].core);
+			});
+			for (auto i = order.begin(); i != order.end(); ++i) { cpus.push_back(available[*i].id); }
+		} else {
+			for (auto c = available.begin(); c != available.end(); ++c) { cpus.push_back(c->id); }
+		}
+	} else {
+		cpus = System::parseCpuList(env.affinity);
+	}
+	if (cpus.empty()) { return cpus; }
+
+	List<int> placement(workerNum);
+	for (int i = 0; i < workerNum; ++i) { placement[i] = cpus[i % cpus.size()]; } // share cpus if there are more workers.
+	return placement;
+}
+
+bool Solver::optimizeGenetic(Solution &sln, Random &rand, ID workerId) {
+	struct Individual {
+		Chromosome genes;
+		Length fitness;
+	};
+
+	BottomLeftDecoder decoder(input);
+	IslandStat &stat(islandStats[workerId]);
+	int rectangleNum = input.rectangles().size();
+	if (rectangleNum < 2) { return optimizeBottomLeft(sln, rand, workerId); }
+
+	List<Individual> population(PopulationSize);
+	Length bestLength = BottomLeftDecoder::NoBound;
+	auto updateBest = [&](Length fitness) {
+		if (fitness >= bestLength) { return; }
+		bestLength = fitness;
+		decoder.toOutput(sln);
+		incumbent.publish(sln, workerId);
+	};
+	auto bestIndex = [&]() {
+		int best = 0;
+		for (int i = 1; i < PopulationSize; ++i) {
+			if (population[i].fitness < population[best].fitness) { best = i; }
+		}
+		return best;
+	};
+	// replace the worst individual if the offspring is no worse than it.
+	auto accept = [&](Chromosome &genes) {
+		int worst = 0;
+		for (int i = 1; i < PopulationSize; ++i) {
+			if (population[i].fitness > population[worst].fitness) { worst = i; }
+		}
+		if (!decoder.decode(genes, population[worst].fitness)) { return false; }
+		population[worst].genes.swap(genes);
+		population[worst].fitness = decoder.side();
+		updateBest(decoder.side());
+		return true;
+	};
+	auto tournament = [&]() {
+		int i = rand.pick(PopulationSize);
+		int j = rand.pick(PopulationSize);
+		return (population[i].fitness <= population[j].fitness) ? i : j;
+	};
+
+	for (int i = 0; i < PopulationSize; ++i) {
+		population[i].genes = decoder.defaultOrder();
+		if (i > 0) { shuffle(population[i].genes.begin(), population[i].genes.end(), rand.rgen); }
+		decoder.decode(population[i].genes);
+		population[i].fitness = decoder.side();
+		updateBest(decoder.side());
+	}
+
+	int islandNum = static_cast<int>(migrationChannels.size());
+	Chromosome child(rectangleNum);
+	List<bool> inherited(rectangleNum);
+	Iteration generation = 0;
+	for (; !timer.isTimeOut() && (generation < env.maxIter); ++generation) {
+		// order crossover keeps a slice of one parent and fills the rest in the order of the other.
+		const Chromosome &p1(population[tournament()].genes);
+		const Chromosome &p2(population[tournament()].genes);
+		int l = rand.pick(rectangleNum);
+		int r = rand.pick(rectangleNum);
+		if (l > r) { swap(l, r); }
+		child.resize(rectangleNum);
+		fill(inherited.begin(), inherited.end(), false);
+		for (int k = l; k <= r; ++k) { inherited[child[k] = p1[k]] = true; }
+		for (int k = 0, g = 0; k < rectangleNum; ++k) {
+			if ((k >= l) && (k <= r)) { continue; }
+			while (inherited[p2[g]]) { ++g; }
+			child[k] = p2[g++];
+		}
+		if (rand.isPicked(1, 2)) { swap(child[rand.pick(rectangleNum)], child[rand.pick(rectangleNum)]); }
+		accept(child);
+
+		if ((islandNum > 1) && ((generation + 1) % MigrationInterval == 0)) {
+			migrationChannels[workerId]->tryPush(population[bestIndex()].genes); // never wait for the neighbor.
+			// in deterministic mode, the neighbor has pushed exactly one emigrant of this round once everyone arrives.
+			if (cfg.deterministic) { syncPoint.arrive(bestLength); }
+			Chromosome migrant;
+			while (migrationChannels[(workerId + islandNum - 1) % islandNum]->tryPop(migrant)) {
+				++stat.migrantNum;
+				if (accept(migrant)) { ++stat.acceptedMigrantNum; }
+				if (cfg.deterministic) { break; } // the emigrant of the next round may have arrived.
+			}
+		}
+	}
+
+	const Chromosome &elite(population[bestIndex()].genes);
+	int diffGeneNum = 0;
+	for (int i = 0; i < PopulationSize; ++i) {
+		for (int k = 0; k < rectangleNum; ++k) { diffGeneNum += (population[i].genes[k] != elite[k]); }
+	}
+	stat.diversity = static_cast<double>(diffGeneNum) / (PopulationSize * rectangleNum);
+	stat.generation = generation;
+	return true;
+}
+
+bool Solver::optimizeRandomly(Solution &sln, Random &rand) {
+	int rectangleNum = input.rectangles().size();
+	BoundingSquare boundingSquare(rectangleNum);
+	SpatialGrid grid(input);
 
 	//replace the following random assignment with your own algorithm
     for (int i = 0; !timer.isTimeOut() && (i < rectangleNum); i++) {
-        int x = rand.pick(0, 100);
-        int y = rand.pick(0, 100);
+        int w = input.rectangles(i).width();
+        int h = input.rectangles(i).height();
+        int x, y;
+        int trial = 0;
+        do { // reject positions overlapping the placed rectangles.
+            x = rand.pick(0, 100);
+            y = rand.pick(0, 100);
+        } while (grid.isOverlapped(x, y, w, h) && (++trial < MaxPlacementTrialNum));
+        if (trial >= MaxPlacementTrialNum) { // nothing lies beyond the right edge of the bounding square.
+            x = boundingSquare.side();
+            y = 0;
+        }
         auto &placement(*sln.add_placements());
         placement.set_id(i);
         placement.set_x(x);
         placement.set_y(y);
         placement.set_rotated(false);
-        maxLength = x + input.rectangles(i).width() > maxLength ? x + input.rectangles(i).width() : maxLength;
-        maxLength = y + input.rectangles(i).height() > maxLength ? y + input.rectangles(i).height() : maxLength;
+        grid.insert(i, x, y, w, h);
+        boundingSquare.place(i, x + w, y + h);
     }
-	sln.set_length(maxLength);
-	
-	Log(LogSwitch::Ck::Framework) << "worker " << workerId << " ends." << endl;
-	return status;
-	
-    
+	sln.set_length(boundingSquare.side());
+	return true;
 }
 #pragma endregion Solver
 
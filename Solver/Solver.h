@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <chrono>
 #include <functional>
+#include <memory>
 #include <sstream>
 #include <thread>
 
@@ -20,6 +21,17 @@
 #include "Utility.h"
 #include "LogSwitch.h"
 #include "Problem.h"
+#include "CsvReader.h"
+#include "SolutionArchive.h"
+#include "SolutionChecker.h"
+#include "BoundingSquare.h"
+#include "SpatialGrid.h"
+#include "BottomLeftDecoder.h"
+#include "HelperTeam.h"
+#include "Incumbent.h"
+#include "SpscQueue.h"
+#include "SyncPoint.h"
+#include "ThreadPool.h"
 
 
 namespace ck {
@@ -27,6 +39,9 @@ namespace ck {
 class Solver {
     #pragma region Type
 public:
+    struct Environment;
+    struct Configuration;
+
     // commmand line interface.
     struct Cli {
         static constexpr int MaxArgLen = 256;
@@ -42,19 +57,33 @@ public:
         static String EnvironmentPathOption() { return "-env"; }
         static String ConfigPathOption() { return "-cfg"; }
         static String LogPathOption() { return "-log"; }
+        static String AffinityOption() { return "-aff"; }
 
         static String AuthorNameSwitch() { return "-name"; }
         static String HelpSwitch() { return "-h"; }
+        static String DeterministicSwitch() { return "-det"; }
+        static String ConvertSwitch() { return "-convert"; }
+        static String BatchSwitch() { return "-batch"; }
+        static String ArchiveSwitch() { return "-archive"; }
 
         static String AuthorName() { return "ck"; }
         static String HelpInfo() {
             return "Pattern (args can be in any order):\n"
-                "  exe (-p path) (-o path) [-s int] [-t seconds] [-name]\n"
+                "  exe (-p path) (-o path) [-s int] [-t seconds] [-name] [-det] [-convert] [-batch]\n"
+                "      [-archive]\n"
                 "      [-iter int] [-j int] [-id string] [-h]\n"
-                "      [-env path] [-cfg path] [-log path]\n"
+                "      [-env path] [-cfg path] [-log path] [-aff policy]\n"
                 "Switches:\n"
                 "  -name  return the identifier of the authors.\n"
                 "  -h     print help information.\n"
+                "  -det   make parallel runs with the same seed reproducible.\n"
+                "  -convert  convert the instance at -p into the format of -o without solving.\n"
+                "  -batch    solve all instances in the batch at -p into the batch at -o.\n"
+                "            with -convert, pack the instances listed in the text file at -p.\n"
+                "  -archive  append the solutions listed in the csv file at -p to the archive at -o.\n"
+                "            each line is the instance path and the solution path separated by ';'.\n"
+                "            with -convert, extract the archive at -p into the solution batch at -o,\n"
+                "            and the instance hash of each solution into the csv file at -o.hash.csv.\n"
                 "Options:\n"
                 "  -p     input instance file path.\n"
                 "  -o     output solution file path.\n"
@@ -66,21 +95,38 @@ public:
                 "  -env   environment file path.\n"
                 "  -cfg   configuration file path.\n"
                 "  -log   activate logging and specify log file path.\n"
+                "  -aff   pin workers to cpus by compact, scatter or a list like 0,2,4-7.\n"
                 "Note:\n"
                 "  0. in pattern, () is non-optional group, [] is optional group\n"
                 "     when -env option is not given.\n"
                 "  1. an environment file contains information of all options.\n"
                 "     explicit options get higher priority than this.\n"
+                "     each line of it is an option and its value separated by ';',\n"
+                "     e.g., \"-t;10\". configuration files use keys alg, job and det.\n"
                 "  2. reaching either timeout or iter will stop the solver.\n"
                 "     if you specify neither of them, the solver will be running\n"
                 "     for a long time. so you should set at least one of them.\n"
                 "  3. the solver will still try to generate an initial solution\n"
                 "     even if the timeout or max iteration is 0. but the solution\n"
-                "     is not guaranteed to be feasible.\n";
+                "     is not guaranteed to be feasible.\n"
+                "  4. deterministic runs are only reproducible if they are\n"
+                "     stopped by the max iteration instead of the timeout.\n"
+                "  5. files whose path ends with .pb are in the binary protobuf format.\n"
+                "     others are in json. the format of input files is detected by content.\n"
+                "  6. batches are streams of size-delimited binary protobuf messages.\n"
+                "     the timeout and max iteration apply to each instance separately.\n";
         }
 
         // a dummy main function.
         static int run(int argc, char *argv[]);
+        // solve the instances in a batch one by one with the workers reused.
+        static int runBatch(const Environment &env, const Configuration &cfg);
+        // pack the instances whose paths are listed in a text file into a batch.
+        static int convertBatch(const Environment &env);
+        // append the solutions listed in a csv file to an archive.
+        static int archive(const Environment &env);
+        // decode all solutions in an archive into a batch.
+        static int extractArchive(const Environment &env);
     };
 
     // controls the I/O data format, exported contents and general usage of the solver.
@@ -88,6 +134,12 @@ public:
         enum Algorithm { Greedy, TreeSearch, DynamicProgramming, LocalSearch, Genetic, MathematicallProgramming };
 
 
+        // keys in the configuration file.
+        static String AlgorithmKey() { return "alg"; }
+        static String ThreadNumKey() { return "job"; }
+        static String DeterministicKey() { return "det"; }
+
+
         Configuration() {}
 
         void load(const String &filePath);
@@ -98,13 +150,15 @@ public:
             String threadNum(std::to_string(threadNumPerWorker));
             std::ostringstream oss;
             oss << "alg=" << alg
-                << ";job=" << threadNum;
+                << ";job=" << threadNum
+                << ";det=" << deterministic;
             return oss.str();
         }
 
 
         Algorithm alg = Configuration::Algorithm::Greedy; // OPTIMIZE[ck][3]: make it a list to specify a series of algorithms to be used by each threads in sequence.
         int threadNumPerWorker = (std::min)(1, static_cast<int>(std::thread::hardware_concurrency()));
+        bool deterministic = false; // exchange information among workers only at synchronization points counted in iterations.
     };
 
     // describe the requirements to the input and output data interface.
@@ -113,7 +167,7 @@ public:
         static constexpr int DefaultMaxIter = (1 << 30);
         static constexpr int DefaultJobNum = 0;
         // preserved time for IO in the total given time.
-        static constexpr int SaveSolutionTimeInMillisecond = 1000;
+        static constexpr int SaveSolutionTimeInMillisecond = 200;
 
         static constexpr Duration RapidModeTimeoutThreshold = 600 * static_cast<Duration>(Timer::MillisecondsPerSecond);
 
@@ -124,6 +178,11 @@ public:
         static String DefaultCfgPath() { return "cfg.csv"; }
         static String DefaultLogPath() { return "log.csv"; }
 
+        // fill the hyperthread siblings of a core and the cores of a socket before moving on.
+        static String CompactAffinity() { return "compact"; }
+        // take one hyperthread of each core first and spread the workers over the sockets.
+        static String ScatterAffinity() { return "scatter"; }
+
         Environment(const String &instancePath, const String &solutionPath,
             int randomSeed = Random::generateSeed(), double timeoutInSecond = DefaultTimeout,
             Iteration maxIteration = DefaultMaxIter, int jobNumber = DefaultJobNum, String runId = "",
@@ -136,6 +195,7 @@ public:
         void load(const Map<String, char*> &optionMap);
         void load(const String &filePath);
         void loadWithoutCalibrate(const String &filePath);
+        void loadOptions(const Map<String, char*> &optionMap); // overwrite the fields with the options in the map.
         void save(const String &filePath) const;
 
         void calibrate(); // adjust job number and timeout to fit the platform.
@@ -166,6 +226,7 @@ public:
         String rid; // the id of each run.
         String cfgPath;
         String logPath;
+        String affinity; // worker placement policy. workers are not pinned if it is empty.
 
         // auto-generated data.
         String localTime;
@@ -176,16 +237,35 @@ public:
 
         Solver *solver;
     };
+
+    using Chromosome = List<ID>; // the sequence of rectangles to be decoded.
+
+    struct IslandStat { // statistics of a worker running the genetic algorithm.
+        Iteration generation = 0;
+        double diversity = 0; // average ratio of genes differing from the best individual.
+        int migrantNum = 0; // number of received individuals.
+        int acceptedMigrantNum = 0; // number of received individuals which entered the population.
+    };
     #pragma endregion Type
 
     #pragma region Constant
 public:
+    // max number of random positions tried for a rectangle before it is put aside.
+    static constexpr int MaxPlacementTrialNum = 64;
+
+    static constexpr int PopulationSize = 32; // number of individuals on each island.
+    static constexpr int MigrationInterval = 64; // number of generations between two migrations.
+    static constexpr int MigrationChannelCapacity = 8; // emigrants are dropped if the channel is full.
+
+    static constexpr int MoveNumPerThread = 4; // number of moves evaluated by each thread in a batch of the parallel local search.
+
+    static constexpr Iteration SyncInterval = 256; // number of iterations between two synchronization points in deterministic mode.
     #pragma endregion Constant
 
     #pragma region Constructor
 public:
-    Solver(const Problem::Input &inputData, const Environment &environment, const Configuration &config)
-        : input(inputData), env(environment), cfg(config), rand(environment.randSeed),
+    Solver(const Problem::Input &inputData, const Environment &environment, const Configuration &config, ThreadPool<> *pool = nullptr)
+        : input(inputData), env(environment), cfg(config), workerPool(pool), rand(environment.randSeed),
         timer(std::chrono::milliseconds(environment.msTimeout)), iteration(1) {}
     #pragma endregion Constructor
 
@@ -198,6 +278,14 @@ public:
 protected:
     void init();
     bool optimize(Solution &sln, ID workerId = 0); // optimize by a single worker.
+    bool optimizeBottomLeft(Solution &sln, Random &rand, ID workerId); // local search over the sequence of a bottom-left-fill decoder.
+    bool optimizeBottomLeftInParallel(Solution &sln, Random &rand, ID workerId); // evaluate the moves of optimizeBottomLeft() in batches on helper threads.
+    bool optimizeRandomly(Solution &sln, Random &rand); // place rectangles at random non-overlapping positions.
+    bool optimizeGenetic(Solution &sln, Random &rand, ID workerId); // evolve an island of sequences for the bottom-left-fill decoder.
+    bool optimizeProbing(Solution &sln, Random &rand, ID workerId); // probe different square sides by the workers together.
+    Length probeTarget(Length upperBound, ID workerId) const; // the side probed by a worker when the best is upperBound.
+    List<int> placeWorkers(int workerNum) const; // the logical processor for each worker by env.affinity.
+    Length sharedLength(Iteration iter, Length localBest, Length &knownLength); // the best side length among all workers for pruning.
     #pragma endregion Method
 
     #pragma region Field
@@ -207,11 +295,20 @@ public:
 
     struct { // auxiliary data for solver.
         List<List<bool>> isCompatible; // isCompatible[f][g] is true if flight f is compatible with gate g.
+        Length lowerBound; // no square with a shorter side can hold all rectangles.
+        int workerNum; // number of workers launched by solve().
     } aux;
 
     Environment env;
     Configuration cfg;
 
+    Incumbent incumbent; // the best solution among all workers.
+    List<std::unique_ptr<SpscQueue<Chromosome>>> migrationChannels; // migrationChannels[i] carries elites from island i to island (i + 1).
+    List<IslandStat> islandStats; // islandStats[i] is only written by worker i.
+    List<int> workerCpus; // workerCpus[i] is the logical processor worker i is pinned to. empty if not pinned.
+    SyncPoint syncPoint; // where workers exchange their best side length in deterministic mode.
+    ThreadPool<> *workerPool; // the workers run in this pool if it is big enough, otherwise in a pool of solve() itself.
+
     Random rand; // all random number in Solver must be generated by this.
     Timer timer; // the solve() should return before it is timeout.
     Iteration iteration;
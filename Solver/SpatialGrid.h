@@ -0,0 +1,175 @@
+////////////////////////////////
+/// usage : 1.	uniform grid index over placed rectangles for overlap queries.
+///
+/// note  : 1.	each rectangle is registered in every cell it covers, so a query only visits
+///             the rectangles sharing a cell with the queried region.
+///         2.	the cell size is tuned to the median rectangle dimension so that most rectangles
+///             cover a handful of cells and most cells hold a handful of rectangles.
+///         3.	queries are not thread-safe since they share the visiting stamps.
+////////////////////////////////
+
+#ifndef SMART_CK_RECT_PACKING_SPATIAL_GRID_H
+#define SMART_CK_RECT_PACKING_SPATIAL_GRID_H
+
+
+#include "Config.h"
+
+#include <algorithm>
+
+#include "Common.h"
+#include "RectPacking.pb.h"
+
+
+namespace ck {
+
+class SpatialGrid {
+public:
+    struct Rect {
+        Coord x;
+        Coord y;
+        Length w;
+        Length h;
+    };
+
+
+    static constexpr ID InvalidId = -1;
+    static constexpr Length DefaultCellSize = 8;
+    static constexpr int DefaultCellNumPerSide = 16;
+
+
+    SpatialGrid(ID rectNum = 0, Length cellSize = DefaultCellSize) { reset(rectNum, cellSize); }
+    SpatialGrid(const pb::RectPacking::Input &input) { reset(input); }
+
+
+    // the median of all widths and heights.
+    static Length medianDimension(const pb::RectPacking::Input &input) {
+        List<Length> dims;
+        dims.reserve(input.rectangles().size() * 2);
+        for (auto r = input.rectangles().begin(); r != input.rectangles().end(); ++r) {
+            dims.push_back(r->width());
+            dims.push_back(r->height());
+        }
+        if (dims.empty()) { return DefaultCellSize; }
+        auto mid = dims.begin() + dims.size() / 2;
+        std::nth_element(dims.begin(), mid, dims.end());
+        return (std::max)(*mid, 1);
+    }
+
+    // remove all rectangles and set the cell size.
+    void reset(ID rectNum, Length cellSize = DefaultCellSize) {
+        cellLen = (std::max)(cellSize, 1);
+        rects.assign(rectNum, { 0, 0, 0, 0 });
+        placed.assign(rectNum, false);
+        stamps.assign(rectNum, 0);
+        stamp = 0;
+        cols = rows = DefaultCellNumPerSide;
+        cells.assign(cols * rows, List<ID>());
+    }
+    void reset(const pb::RectPacking::Input &input) {
+        reset(static_cast<ID>(input.rectangles().size()), medianDimension(input));
+    }
+
+    // the rectangle must not have been inserted.
+    void insert(ID r, Coord x, Coord y, Length w, Length h) {
+        int c1 = col(x + w - 1);
+        int r1 = row(y + h - 1);
+        if ((c1 >= cols) || (r1 >= rows)) { grow(c1 + 1, r1 + 1); } // before registering r, or it would be added twice.
+        rects[r] = { x, y, w, h };
+        placed[r] = true;
+        for (int i = row(y); i <= r1; ++i) {
+            for (int j = col(x); j <= c1; ++j) { cells[i * cols + j].push_back(r); }
+        }
+    }
+    // the rectangle must have been inserted.
+    void erase(ID r) {
+        const Rect &rect(rects[r]);
+        int c1 = col(rect.x + rect.w - 1);
+        int r1 = row(rect.y + rect.h - 1);
+        for (int i = row(rect.y); i <= r1; ++i) {
+            for (int j = col(rect.x); j <= c1; ++j) {
+                List<ID> &cell(cells[i * cols + j]);
+                *std::find(cell.begin(), cell.end(), r) = cell.back();
+                cell.pop_back();
+            }
+        }
+        placed[r] = false;
+    }
+    // the rectangle must have been inserted. (w, h) can be swapped for rotation.
+    void move(ID r, Coord x, Coord y, Length w, Length h) {
+        erase(r);
+        insert(r, x, y, w, h);
+    }
+    void move(ID r, Coord x, Coord y) { move(r, x, y, rects[r].w, rects[r].h); }
+
+    // append the rectangles overlapping the given region except the specified one to overlaps.
+    void queryOverlaps(Coord x, Coord y, Length w, Length h, List<ID> &overlaps, ID except = InvalidId) const {
+        forEachOverlap(x, y, w, h, except, [&](ID r) { overlaps.push_back(r); return false; });
+    }
+    void queryOverlaps(ID r, List<ID> &overlaps) const {
+        const Rect &rect(rects[r]);
+        queryOverlaps(rect.x, rect.y, rect.w, rect.h, overlaps, r);
+    }
+
+    bool isOverlapped(Coord x, Coord y, Length w, Length h, ID except = InvalidId) const {
+        return forEachOverlap(x, y, w, h, except, [](ID) { return true; });
+    }
+
+    bool isPlaced(ID r) const { return placed[r]; }
+    const Rect& rect(ID r) const { return rects[r]; }
+    Length cellSize() const { return cellLen; }
+
+protected:
+    // call onOverlap(r) on each overlapping rectangle once until it returns true.
+    template<typename OnOverlap>
+    bool forEachOverlap(Coord x, Coord y, Length w, Length h, ID except, OnOverlap onOverlap) const {
+        if ((w <= 0) || (h <= 0)) { return false; }
+        if (++stamp == 0) { std::fill(stamps.begin(), stamps.end(), 0); stamp = 1; } // avoid false visits on overflow.
+        int c1 = (std::min)(col(x + w - 1), cols - 1);
+        int r1 = (std::min)(row(y + h - 1), rows - 1);
+        for (int i = row(y); i <= r1; ++i) {
+            for (int j = col(x); j <= c1; ++j) {
+                const List<ID> &cell(cells[i * cols + j]);
+                for (auto r = cell.begin(); r != cell.end(); ++r) {
+                    if ((*r == except) || (stamps[*r] == stamp)) { continue; }
+                    stamps[*r] = stamp;
+                    const Rect &o(rects[*r]);
+                    if ((x < o.x + o.w) && (o.x < x + w) && (y < o.y + o.h) && (o.y < y + h)) {
+                        if (onOverlap(*r)) { return true; }
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    // enlarge the grid to cover at least colNum * rowNum cells and re-register all rectangles.
+    void grow(int colNum, int rowNum) {
+        cols = (std::max)(colNum, cols * 2);
+        rows = (std::max)(rowNum, rows * 2);
+        cells.assign(cols * rows, List<ID>());
+        for (ID r = 0; r < static_cast<ID>(rects.size()); ++r) {
+            if (placed[r]) { insert(r, rects[r].x, rects[r].y, rects[r].w, rects[r].h); }
+        }
+    }
+
+    // coordinates out of the non-negative quadrant are clamped to the border cells.
+    int col(Coord x) const { return (x <= 0) ? 0 : (x / cellLen); }
+    int row(Coord y) const { return (y <= 0) ? 0 : (y / cellLen); }
+
+
+    Length cellLen;
+    int cols;
+    int rows;
+    List<List<ID>> cells; // cells[i * cols + j] lists the rectangles covering the cell in row i and column j.
+
+    List<Rect> rects; // rects[r] is the last inserted region of rectangle r.
+    List<bool> placed; // placed[r] is true if rectangle r is in the grid.
+
+    mutable List<int> stamps; // stamps[r] == stamp if rectangle r has been visited in the current query.
+    mutable int stamp;
+};
+
+}
+
+
+#endif // SMART_CK_RECT_PACKING_SPATIAL_GRID_H
@@ -0,0 +1,76 @@
+////////////////////////////////
+/// usage : 1.	bounded lock-free ring buffer for one producer thread and one consumer thread.
+///
+/// note  : 1.	neither side ever blocks. tryPush() fails if the buffer is full and
+///             tryPop() fails if it is empty, so the caller decides whether to drop or retry.
+///         2.	the capacity is rounded up to a power of 2.
+////////////////////////////////
+
+#ifndef SMART_CK_RECT_PACKING_SPSC_QUEUE_H
+#define SMART_CK_RECT_PACKING_SPSC_QUEUE_H
+
+
+#include "Config.h"
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+
+namespace ck {
+
+template<typename T>
+class SpscQueue {
+public:
+    using Index = unsigned long long;
+
+
+    static constexpr int CacheLineSize = 64;
+
+
+    SpscQueue(int capacity) : mask(roundUp(capacity) - 1), slots(new T[mask + 1]), head(0), tail(0) {}
+
+
+    // called by the producer only.
+    bool tryPush(T &&item) {
+        Index h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) > mask) { return false; } // full.
+        slots[h & mask] = std::move(item);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+    bool tryPush(const T &item) { return tryPush(T(item)); }
+
+    // called by the consumer only.
+    bool tryPop(T &item) {
+        Index t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) { return false; } // empty.
+        item = std::move(slots[t & mask]);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // the result is only a hint since the other side may change it concurrently.
+    bool empty() const { return (head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire)); }
+
+    Index capacity() const { return mask + 1; }
+
+protected:
+    static Index roundUp(int capacity) {
+        Index c = 1;
+        while (c < static_cast<Index>(capacity)) { c <<= 1; }
+        return c;
+    }
+
+
+    const Index mask;
+    std::unique_ptr<T[]> slots;
+
+    alignas(CacheLineSize) std::atomic<Index> head; // next slot to write. owned by the producer.
+    alignas(CacheLineSize) std::atomic<Index> tail; // next slot to read. owned by the consumer.
+};
+
+}
+
+
+#endif // SMART_CK_RECT_PACKING_SPSC_QUEUE_H
@@ -0,0 +1,107 @@
+////////////////////////////////
+/// usage : 1.	occupancy raster of the packing grid with a summed-area table (2D prefix sum)
+///             to count the occupied cells in any axis-aligned region in O(1).
+///
+/// note  : 1.	updates are batched. fill() only touches the raster and records the dirty
+///             corner, and commit() rebuilds the prefix sums to the upper right of it.
+///         2.	regions are clipped to the raster, i.e., cells outside are regarded as free.
+////////////////////////////////
+
+#ifndef SMART_CK_RECT_PACKING_SUMMED_AREA_TABLE_H
+#define SMART_CK_RECT_PACKING_SUMMED_AREA_TABLE_H
+
+
+#include "Config.h"
+
+#include <algorithm>
+
+#include "Common.h"
+#include "Utility.h"
+
+
+namespace ck {
+
+class SummedAreaTable {
+public:
+    using Area = int;
+
+
+    SummedAreaTable(Length width = 0, Length height = 0) { reset(width, height); }
+
+
+    // clear the raster of width * height cells.
+    void reset(Length width, Length height) {
+        if ((width != cols) || (height != rows)) {
+            cols = width;
+            rows = height;
+            cells.clear();
+            cells.init(rows, cols);
+            prefix.clear();
+            prefix.init(rows + 1, cols + 1);
+        }
+        cells.reset();
+        prefix.reset();
+        dirtyRow = rows;
+        dirtyCol = cols;
+    }
+
+    // add delta to the occupancy of cells in [x, x + w) * [y, y + h).
+    // the change is not visible to queries until commit().
+    void fill(Coord x, Coord y, Length w, Length h, int delta = 1) {
+        Coord x0 = (std::max)(x, 0), x1 = (std::min)(x + w, cols);
+        Coord y0 = (std::max)(y, 0), y1 = (std::min)(y + h, rows);
+        if ((x0 >= x1) || (y0 >= y1)) { return; }
+        for (Coord i = y0; i < y1; ++i) {
+            int *row = cells[i];
+            for (Coord j = x0; j < x1; ++j) { row[j] += delta; }
+        }
+        dirtyRow = (std::min)(dirtyRow, y0);
+        dirtyCol = (std::min)(dirtyCol, x0);
+    }
+    void erase(Coord x, Coord y, Length w, Length h) { fill(x, y, w, h, -1); }
+
+    // make all filled cells visible to queries.
+    // only prefix[i][j] with i > dirtyRow and j > dirtyCol depend on the updated cells.
+    void commit() {
+        for (Coord i = dirtyRow; i < rows; ++i) {
+            const int *cell = cells[i];
+            const Area *lower = prefix[i];
+            Area *upper = prefix[i + 1];
+            for (Coord j = dirtyCol; j < cols; ++j) {
+                upper[j + 1] = cell[j] + lower[j + 1] + upper[j] - lower[j];
+            }
+        }
+        dirtyRow = rows;
+        dirtyCol = cols;
+    }
+
+    bool isDirty() const { return (dirtyRow < rows); }
+
+    // number of occupied cells in [x, x + w) * [y, y + h) as of the last commit().
+    Area occupied(Coord x, Coord y, Length w, Length h) const {
+        Coord x0 = Math::bound(x, 0, cols), x1 = Math::bound(x + w, 0, cols);
+        Coord y0 = Math::bound(y, 0, rows), y1 = Math::bound(y + h, 0, rows);
+        if ((x0 >= x1) || (y0 >= y1)) { return 0; }
+        return prefix.at(y1, x1) - prefix.at(y0, x1) - prefix.at(y1, x0) + prefix.at(y0, x0);
+    }
+    // number of free cells in [x, x + w) * [y, y + h) as of the last commit().
+    Area vacant(Coord x, Coord y, Length w, Length h) const { return (w * h) - occupied(x, y, w, h); }
+
+    Length width() const { return cols; }
+    Length height() const { return rows; }
+
+protected:
+    Length cols = -1;
+    Length rows = -1;
+
+    Arr2D<int> cells; // cells[y][x] is the occupancy of the unit square at (x, y).
+    Arr2D<Area> prefix; // prefix[i][j] is the total occupancy in [0, j) * [0, i).
+
+    Coord dirtyRow; // the lowest row updated since the last commit.
+    Coord dirtyCol; // the leftmost column updated since the last commit.
+};
+
+}
+
+
+#endif // SMART_CK_RECT_PACKING_SUMMED_AREA_TABLE_H
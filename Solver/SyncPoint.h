@@ -0,0 +1,91 @@
+////////////////////////////////
+/// usage : 1.	a reusable barrier where workers exchange their best side length in rounds.
+///
+/// note  : 1.	every round ends when all participating workers have arrived, and all of them
+///             get the same result no matter in which order they arrived.
+///         2.	a worker which stops early must leave(), so the others never wait for it.
+///             its last value is still taken into account in all later rounds.
+////////////////////////////////
+
+#ifndef SMART_CK_RECT_PACKING_SYNC_POINT_H
+#define SMART_CK_RECT_PACKING_SYNC_POINT_H
+
+
+#include "Config.h"
+
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+
+#include "Common.h"
+
+
+namespace ck {
+
+class SyncPoint {
+public:
+    using Lock = std::unique_lock<std::mutex>;
+
+
+    static constexpr Length NoValue = (1 << 30);
+
+
+    SyncPoint(int participantNum = 0) { reset(participantNum); }
+
+
+    // must not be called concurrently with any other method.
+    void reset(int participantNum) {
+        activeNum = participantNum;
+        arrivedNum = 0;
+        round = 0;
+        roundMin = NoValue;
+        leftMin = NoValue;
+        result = NoValue;
+    }
+
+    // block until all participants arrive, then return the minimum value among them.
+    Length arrive(Length value) {
+        Lock lock(mutex);
+        roundMin = (std::min)(roundMin, value);
+        long long r = round;
+        if (++arrivedNum >= activeNum) {
+            finishRound();
+        } else {
+            cv.wait(lock, [&]() { return (round != r); });
+        }
+        return result;
+    }
+
+    // stop participating in the following rounds.
+    void leave(Length value) {
+        Lock lock(mutex);
+        leftMin = (std::min)(leftMin, value);
+        --activeNum;
+        if ((arrivedNum > 0) && (arrivedNum >= activeNum)) { finishRound(); } // the others are waiting for this one.
+    }
+
+protected:
+    void finishRound() {
+        result = (std::min)(roundMin, leftMin);
+        roundMin = NoValue;
+        arrivedNum = 0;
+        ++round;
+        cv.notify_all();
+    }
+
+
+    int activeNum; // number of workers who have not left.
+    int arrivedNum; // number of workers arrived in the current round.
+    long long round;
+    Length roundMin; // minimum value brought by the workers arrived in the current round.
+    Length leftMin; // minimum value left by the workers who have stopped.
+    Length result; // the result of the last finished round.
+
+    std::mutex mutex;
+    std::condition_variable cv;
+};
+
+}
+
+
+#endif // SMART_CK_RECT_PACKING_SYNC_POINT_H
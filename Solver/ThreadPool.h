@@ -0,0 +1,765 @@
+////////////////////////////////
+/// usage : 1.	a simple hread pool with optional return value retrieval (submit()).
+///         2.	use WorkStealingImpl for jobs which push subjobs recursively.
+///             use LockFreeQueueImpl for many short jobs pushed from outside of the pool.
+///         3.	TaskGroup, parallelFor() and parallelReduce() run a subset of jobs on a shared pool.
+/// 
+/// note  : 1.	
+////////////////////////////////
+
+#ifndef CK_CPPUTILIBS_THREAD_POOL_H
+#define CK_CPPUTILIBS_THREAD_POOL_H
+
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <vector>
+#include <queue>
+#include <functional>
+#include <future>
+#include <memory>
+#include <utility>
+#include <algorithm>
+
+#include <cstddef>
+
+
+namespace ck {
+
+namespace impl {
+
+// [NoReturnValueRetrieval][NotExceptionSafe]
+// [ManualStart][ManualPend][ManualStop]
+class ThreadPoolBase {
+public:
+    enum State { Run, Pend, Stop };
+
+
+    using Size = int;
+    using Job = std::function<void(void)>;
+    using Worker = std::thread;
+    using Lock = std::unique_lock<std::mutex>;
+
+
+    static Size getDefaultWorkerNum() { return Worker::hardware_concurrency(); }
+
+
+    // you may want to start() once the pool is constructed in the derived classes.
+    ThreadPoolBase(Size threadNum) : workerPool(threadNum) {}
+    // you may want to pend() once the pool is destructed in the derived classes.
+    virtual ~ThreadPoolBase() {}
+
+
+    // make all workers ready to work.
+    // you could restart after pend() or stop().
+    virtual void start() {
+        setState(State::Run);
+        launchAll();
+    }
+    // terminate all workers after all pushed jobs are done.
+    virtual void pend() {
+        setState(State::Pend);
+        waitAll(); // OPTIMIZE[ck][0]: detach and move on instead of waiting?
+    }
+    // terminate all workers after all taken jobs are done.
+    virtual void stop() {
+        setState(State::Stop);
+        waitAll();
+    }
+
+    virtual void push(Job &&newJob) = 0;
+
+    virtual State getState() = 0;
+
+    Size threadNum() const { return static_cast<Size>(workerPool.size()); }
+
+protected:
+    // the main loop of taking and executeing jobs for single worker thread.
+    virtual void work() = 0;
+
+    virtual void setState(State state) = 0;
+
+    void launchAll() {
+        for (auto worker = workerPool.begin(); worker != workerPool.end(); ++worker) {
+            *worker = Worker([this]() { work(); });
+        }
+    }
+    void waitAll() {
+        for (auto worker = workerPool.begin(); worker != workerPool.end(); ++worker) {
+            if (worker->joinable()) { worker->join(); }
+        }
+    }
+
+    static bool isValidJob(const Job &job) { return static_cast<bool>(job); }
+
+    static void dummyJob() {}
+
+
+    std::vector<Worker> workerPool;
+};
+
+class ThreadPool {
+public:
+// [NoReturnValueRetrieval][NotExceptionSafe]
+// [ManualStart][ManualPend][ManualStop]
+    class QueueImpl : public ThreadPoolBase {
+    public:
+        using ThreadPoolBase::ThreadPoolBase;
+
+
+        virtual void stop() override {
+            setState(State::Stop);
+            jobCv.notify_all(); // terminate sleeping workers.
+            waitAll();
+        }
+        virtual void pend() override {
+            setState(State::Pend);
+            jobCv.notify_all(); // terminate sleeping workers.
+            waitAll();
+        }
+
+        virtual void push(Job &&newJob) override {
+            Lock jobLock(jobMutex);
+            jobQueue.push(newJob);
+            jobLock.unlock();
+
+            jobCv.notify_one();
+        }
+
+        virtual State getState() override {
+            Lock jobLock(jobMutex);
+            return state;
+        }
+
+    protected:
+        virtual void work() override {
+            for (;;) {
+                Lock jobLock(jobMutex);
+
+                if (jobQueue.empty()) {
+                    if (state != State::Run) { return; } // all pending jobs finished.
+                    jobCv.wait(jobLock);
+                    if (jobQueue.empty()) {
+                        if (state != State::Run) { return; } // all pending jobs finished.
+                        continue;  // skip spurious wake up.
+                    }
+                }
+                if (state == State::Stop) { return; }
+
+                Job newJob(std::move(jobQueue.front()));
+                jobQueue.pop();
+
+                jobLock.unlock();
+
+                newJob();
+            }
+        }
+
+        virtual void setState(State newState) override {
+            Lock jobLock(jobMutex);
+            state = newState;
+        }
+
+
+        State state;
+
+        std::queue<Job> jobQueue;
+
+        std::mutex jobMutex;
+        std::condition_variable jobCv;
+    };
+
+
+    // [NoReturnValueRetrieval][NotExceptionSafe]
+    // [ManualStart][ManualPend][ManualStop]
+    class SingleSlotImpl : public ThreadPoolBase {
+    public:
+        using ThreadPoolBase::ThreadPoolBase;
+
+
+        virtual void stop() override {
+            setState(State::Stop);
+            jobCv.notify_all();
+            waitAll();
+        }
+        virtual void pend() override {
+            setState(State::Pend);
+            jobCv.notify_all();
+            waitAll();
+        }
+
+        virtual void push(Job &&newJob) override {
+            Lock jobLock(jobMutex); // the slot is guarded by the same mutex on both sides.
+            workerCv.wait(jobLock, [this]() { return isSlotEmpty(); }); // OPTIMIZE[ck][0]: assume spurious wake up will never happen?
+            nextJob = std::move(newJob); // make the new job available for taking.
+            jobLock.unlock();
+
+            jobCv.notify_one(); // declare that a new job is available (wake up a worker to take the new job).
+        }
+
+        virtual State getState() override { return state; }
+
+    protected:
+        virtual void work() override {
+            for (;;) {
+                Lock jobLock(jobMutex); // wait until a new job is available.
+
+                if (isSlotEmpty()) {
+                    if (state != State::Run) { return; } // all pending jobs finished.
+                    jobCv.wait(jobLock);
+                    if (isSlotEmpty()) {
+                        if (state != State::Run) { return; } // all pending jobs finished.
+                        continue;  // skip spurious wake up.
+                    }
+                }
+                if (state == State::Stop) { return; }
+
+                Job newJob(std::move(nextJob)); // take the new job.
+                nextJob = nullptr; // a moved-from function is not guaranteed to be empty.
+                jobLock.unlock();
+
+                workerCv.notify_one(); // declare that the job has been taken (wake up the dispatcher to enable a new job).
+                newJob(); // do the job.
+            }
+        }
+
+        virtual void setState(State newState) override {
+            Lock jobLock(jobMutex); // avoid missing the notification between checking the state and waiting.
+            state = newState;
+        }
+
+        bool isSlotEmpty() const { return !isValidJob(nextJob); }
+
+
+        std::atomic<State> state;
+
+        Job nextJob;
+
+        std::mutex jobMutex;
+        std::condition_variable jobCv;
+        std::condition_variable workerCv;
+    };
+
+
+    // [NoReturnValueRetrieval][NotExceptionSafe]
+    // [ManualStart][ManualPend][ManualStop]
+    // jobs are passed through a bounded lock-free ring buffer (Vyukov's MPMC queue), so pushing
+    // and taking a job cost a compare-and-swap instead of a mutex handoff. idle workers spin for
+    // a while before parking on a condition variable, and so does push() if the buffer is full.
+    class LockFreeQueueImpl : public ThreadPoolBase {
+    public:
+        using Index = std::size_t;
+
+
+        static constexpr Size DefaultCapacity = 1024;
+        static constexpr int SpinNum = 64; // number of retries before yielding.
+        static constexpr int YieldNum = 16; // number of retries with yielding before parking.
+        static constexpr int CacheLineSize = 64;
+
+
+        LockFreeQueueImpl(Size threadNum, Size capacity = DefaultCapacity)
+            : ThreadPoolBase(threadNum), mask(roundUp(capacity) - 1), cells(new Cell[mask + 1]) {
+            resetCells();
+        }
+
+
+        virtual void start() override {
+            resetCells();
+            ThreadPoolBase::start();
+        }
+        virtual void stop() override {
+            setState(State::Stop);
+            waitAll();
+        }
+        virtual void pend() override {
+            setState(State::Pend);
+            waitAll();
+        }
+
+        virtual void push(Job &&newJob) override {
+            for (int trial = 0; !tryPush(newJob); ++trial) {
+                if (trial < SpinNum) { continue; }
+                if (trial < SpinNum + YieldNum) { std::this_thread::yield(); continue; }
+                Lock parkLock(parkMutex);
+                ++sleepingProducerNum;
+                spaceCv.wait(parkLock, [this]() { return !isFull() || (state == State::Stop); });
+                --sleepingProducerNum;
+                if (state == State::Stop) { return; } // the job would never be taken.
+                trial = 0;
+            }
+            wake(sleepingWorkerNum, jobCv);
+        }
+
+        virtual State getState() override { return state; }
+
+    protected:
+        struct alignas(CacheLineSize) Cell {
+            std::atomic<Index> seq; // the cell is ready for the push at seq or the pop at (seq - 1).
+            Job job;
+        };
+
+
+        static Index roundUp(Size capacity) {
+            Index c = 2;
+            while (c < static_cast<Index>(capacity)) { c <<= 1; }
+            return c;
+        }
+
+        virtual void work() override {
+            for (Job newJob;;) {
+                for (int trial = 0; (state != State::Stop) && !tryPop(newJob); ++trial) {
+                    if (trial < SpinNum) { continue; }
+                    if (trial < SpinNum + YieldNum) { std::this_thread::yield(); continue; }
+                    Lock parkLock(parkMutex);
+                    ++sleepingWorkerNum;
+                    jobCv.wait(parkLock, [this]() { return !isEmpty() || (state != State::Run); });
+                    --sleepingWorkerNum;
+                    if (isEmpty() && (state != State::Run)) { return; } // all pending jobs finished.
+                    trial = 0;
+                }
+                if (state == State::Stop) { return; }
+
+                wake(sleepingProducerNum, spaceCv);
+                newJob();
+                newJob = nullptr; // release the captured resources before waiting for the next job.
+            }
+        }
+
+        bool tryPush(Job &newJob) {
+            Index pos = enqueuePos.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell &cell(cells[pos & mask]);
+                Index seq = cell.seq.load(std::memory_order_acquire);
+                std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq - pos);
+                if (diff == 0) {
+                    if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        cell.job = std::move(newJob);
+                        cell.seq.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) { // full.
+                    return false;
+                } else { // another producer took the cell.
+                    pos = enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+        bool tryPop(Job &newJob) {
+            Index pos = dequeuePos.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell &cell(cells[pos & mask]);
+                Index seq = cell.seq.load(std::memory_order_acquire);
+                std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+                if (diff == 0) {
+                    if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        newJob = std::move(cell.job);
+                        cell.seq.store(pos + mask + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) { // empty.
+                    return false;
+                } else { // another worker took the cell.
+                    pos = dequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool isEmpty() const {
+            Index pos = dequeuePos.load(std::memory_order_seq_cst);
+            return (cells[pos & mask].seq.load(std::memory_order_seq_cst) != pos + 1);
+        }
+        bool isFull() const {
+            Index pos = enqueuePos.load(std::memory_order_seq_cst);
+            return (cells[pos & mask].seq.load(std::memory_order_seq_cst) != pos);
+        }
+
+        // the fence pairs with the increment of the sleeper counter under the park mutex,
+        // so either the sleeper sees the change or the waker sees the sleeper.
+        void wake(std::atomic<int> &sleeperNum, std::condition_variable &cv) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sleeperNum.load(std::memory_order_seq_cst) > 0) {
+                { Lock parkLock(parkMutex); } // make sure the sleeper is waiting on the cv.
+                cv.notify_one();
+            }
+        }
+
+        virtual void setState(State newState) override {
+            { Lock parkLock(parkMutex); state = newState; }
+            jobCv.notify_all();
+            spaceCv.notify_all();
+        }
+
+        // drop the jobs which have not been taken.
+        void resetCells() {
+            for (Index i = 0; i <= mask; ++i) {
+                cells[i].job = nullptr;
+                cells[i].seq.store(i, std::memory_order_relaxed);
+            }
+            enqueuePos.store(0, std::memory_order_relaxed);
+            dequeuePos.store(0, std::memory_order_relaxed);
+        }
+
+
+        std::atomic<State> state;
+
+        const Index mask;
+        std::unique_ptr<Cell[]> cells;
+        alignas(CacheLineSize) std::atomic<Index> enqueuePos;
+        alignas(CacheLineSize) std::atomic<Index> dequeuePos;
+
+        std::atomic<int> sleepingWorkerNum{ 0 };
+        std::atomic<int> sleepingProducerNum{ 0 };
+        std::mutex parkMutex;
+        std::condition_variable jobCv; // signaled when a job is pushed.
+        std::condition_variable spaceCv; // signaled when a job is taken.
+    };
+
+
+    // [NoReturnValueRetrieval][NotExceptionSafe]
+    // [ManualStart][ManualPend][ManualStop]
+    // each worker owns a Chase-Lev deque. jobs pushed by a worker (subjobs) go to the bottom
+    // of its own deque and are taken LIFO, while idle workers steal from the top of the
+    // deque of random victims. jobs pushed by other threads go through a shared inbox.
+    class WorkStealingImpl : public ThreadPoolBase {
+    public:
+        using ThreadPoolBase::ThreadPoolBase;
+
+
+        virtual ~WorkStealingImpl() { clearJobs(); }
+
+
+        virtual void start() override {
+            clearJobs();
+            deques.clear();
+            for (Size i = 0; i < static_cast<Size>(workerPool.size()); ++i) { deques.emplace_back(new Deque()); }
+            nextWorkerIndex = 0;
+            ThreadPoolBase::start();
+        }
+        virtual void stop() override {
+            setState(State::Stop);
+            waitAll();
+            clearJobs(); // drop the jobs which have not been taken.
+        }
+        virtual void pend() override {
+            setState(State::Pend);
+            waitAll();
+        }
+
+        virtual void push(Job &&newJob) override {
+            Job *job = new Job(std::move(newJob));
+            ++unfinishedJobNum;
+            if ((currentPool() == this) && (currentWorker() >= 0)) { // a subjob.
+                deques[currentWorker()]->push(job);
+            } else {
+                Lock inboxLock(inboxMutex);
+                inbox.push(job);
+            }
+            ++queuedJobNum;
+            if (sleepingWorkerNum > 0) {
+                { Lock parkLock(parkMutex); } // make sure the sleeping worker is waiting on the cv.
+                parkCv.notify_one();
+            }
+        }
+
+        virtual State getState() override { return state; }
+
+    protected:
+        // a circular array which only grows.
+        struct Ring {
+            Ring(long long capacity) : mask(capacity - 1), slots(new std::atomic<Job*>[capacity]) {}
+
+            Job* get(long long i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+            void put(long long i, Job *job) { slots[i & mask].store(job, std::memory_order_relaxed); }
+            long long capacity() const { return mask + 1; }
+
+            long long mask;
+            std::unique_ptr<std::atomic<Job*>[]> slots;
+        };
+
+        // Chase-Lev deque with the memory orders from "Correct and Efficient Work-Stealing
+        // for Weak Memory Models" (Le et al., PPoPP 2013).
+        struct Deque {
+            static constexpr long long InitCapacity = 64;
+
+            Deque() : top(0), bottom(0) {
+                rings.emplace_back(new Ring(InitCapacity));
+                ring = rings.back().get();
+            }
+
+            // owner only.
+            void push(Job *job) {
+                long long b = bottom.load(std::memory_order_relaxed);
+                long long t = top.load(std::memory_order_acquire);
+                Ring *r = ring.load(std::memory_order_relaxed);
+                if (b - t > r->capacity() - 1) { r = grow(r, t, b); }
+                r->put(b, job);
+                std::atomic_thread_fence(std::memory_order_release);
+                bottom.store(b + 1, std::memory_order_relaxed);
+            }
+            // owner only.
+            Job* pop() {
+                long long b = bottom.load(std::memory_order_relaxed) - 1;
+                Ring *r = ring.load(std::memory_order_relaxed);
+                bottom.store(b, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                long long t = top.load(std::memory_order_relaxed);
+                if (t > b) { // empty.
+                    bottom.store(b + 1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+                Job *job = r->get(b);
+                if (t == b) { // the last job may be stolen at the same time.
+                    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) { job = nullptr; }
+                    bottom.store(b + 1, std::memory_order_relaxed);
+                }
+                return job;
+            }
+            // any thread.
+            Job* steal() {
+                long long t = top.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                long long b = bottom.load(std::memory_order_acquire);
+                if (t >= b) { return nullptr; } // empty.
+                Job *job = ring.load(std::memory_order_acquire)->get(t);
+                if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) { return nullptr; } // lost the race.
+                return job;
+            }
+
+            // old rings are kept alive since thieves may still be reading them.
+            Ring* grow(Ring *r, long long t, long long b) {
+                rings.emplace_back(new Ring(r->capacity() * 2));
+                Ring *newRing = rings.back().get();
+                for (long long i = t; i < b; ++i) { newRing->put(i, r->get(i)); }
+                ring.store(newRing, std::memory_order_release);
+                return newRing;
+            }
+
+            std::atomic<long long> top;
+            std::atomic<long long> bottom;
+            std::atomic<Ring*> ring;
+            std::vector<std::unique_ptr<Ring>> rings;
+        };
+
+
+        static WorkStealingImpl*& currentPool() {
+            static thread_local WorkStealingImpl *pool = nullptr;
+            return pool;
+        }
+        static Size& currentWorker() {
+            static thread_local Size worker = -1;
+            return worker;
+        }
+
+        virtual void work() override {
+            Size self = nextWorkerIndex++;
+            currentPool() = this;
+            currentWorker() = self;
+            unsigned seed = static_cast<unsigned>(self) * 2654435761u + 1;
+
+            for (;;) {
+                if (state == State::Stop) { return; }
+
+                Job *job = takeJob(self, seed);
+                if (job) {
+                    --queuedJobNum;
+                    (*job)();
+                    delete job;
+                    if (--unfinishedJobNum == 0) { // wake up workers waiting to terminate.
+                        { Lock parkLock(parkMutex); }
+                        parkCv.notify_all();
+                    }
+                    continue;
+                }
+
+                Lock parkLock(parkMutex);
+                ++sleepingWorkerNum;
+                parkCv.wait(parkLock, [this]() {
+                    return (queuedJobNum > 0) || (state == State::Stop) || ((state == State::Pend) && (unfinishedJobNum == 0));
+                });
+                --sleepingWorkerNum;
+                if ((queuedJobNum <= 0) && (state != State::Run)) { return; } // all pending jobs finished.
+            }
+        }
+
+        // take from the own deque first, then the inbox, and then steal from random victims.
+        Job* takeJob(Size self, unsigned &seed) {
+            Job *job = deques[self]->pop();
+            if (job) { return job; }
+
+            {
+                Lock inboxLock(inboxMutex);
+                if (!inbox.empty()) {
+                    job = inbox.front();
+                    inbox.pop();
+                    return job;
+                }
+            }
+
+            Size workerNum = static_cast<Size>(deques.size());
+            for (Size i = 0; i < 2 * workerNum; ++i) {
+                seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5; // xorshift.
+                Size victim = seed % workerNum;
+                if (victim == self) { continue; }
+                if ((job = deques[victim]->steal()) != nullptr) { return job; }
+            }
+            for (Size victim = 0; victim < workerNum; ++victim) { // make sure no queued job is missed before parking.
+                if ((victim != self) && ((job = deques[victim]->steal()) != nullptr)) { return job; }
+            }
+            return nullptr;
+        }
+
+        virtual void setState(State newState) override {
+            { Lock parkLock(parkMutex); state = newState; }
+            parkCv.notify_all();
+        }
+
+        void clearJobs() {
+            for (auto d = deques.begin(); d != deques.end(); ++d) {
+                for (Job *job; (job = (*d)->pop()) != nullptr; delete job) {}
+            }
+            for (; !inbox.empty(); inbox.pop()) { delete inbox.front(); }
+            queuedJobNum = 0;
+            unfinishedJobNum = 0;
+        }
+
+
+        std::atomic<State> state;
+
+        std::vector<std::unique_ptr<Deque>> deques; // deques[i] is owned by the i_th worker.
+        std::atomic<Size> nextWorkerIndex;
+
+        std::queue<Job*> inbox; // jobs pushed by threads out of the pool.
+        std::mutex inboxMutex;
+
+        std::atomic<int> queuedJobNum{ 0 }; // number of jobs pushed but not taken.
+        std::atomic<int> unfinishedJobNum{ 0 }; // number of jobs pushed but not finished.
+        std::atomic<int> sleepingWorkerNum{ 0 };
+        std::mutex parkMutex;
+        std::condition_variable parkCv;
+    };
+};
+
+}
+
+// [NotExceptionSafe]
+// [AutoStart][AutoPend][ManualStop]
+template<typename ThreadPoolImpl = impl::ThreadPool::QueueImpl>
+class ThreadPool : public ThreadPoolImpl {
+public:
+    ThreadPool(int threadNum) : ThreadPoolImpl(threadNum) { this->start(); }
+    ThreadPool() : ThreadPool(ThreadPoolImpl::getDefaultWorkerNum()) {}
+    virtual ~ThreadPool() { this->pend(); }
+
+
+    using ThreadPoolImpl::push;
+    // avoid copying function objects. the const reference can be handled automatically.
+    template<typename Functor>
+    void push(Functor &newJob) { push(std::ref(newJob)); } // or use `push([&newJob]() { newJob(); });`.
+
+    // push a job and retrieve its return value (or the exception it throws) through the future.
+    template<typename Functor>
+    auto submit(Functor &&newJob) -> std::future<decltype(newJob())> {
+        using Result = decltype(newJob());
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Functor>(newJob));
+        std::future<Result> result(task->get_future());
+        push([task]() { (*task)(); });
+        return result;
+    }
+};
+
+
+// a subset of jobs in a pool which can be waited for or cancelled together.
+// waiting inside a job of the same pool may deadlock if all workers end up waiting.
+// the first exception thrown by the jobs is rethrown by wait(), and the others are dropped.
+template<typename Pool>
+class TaskGroup {
+public:
+    using Lock = std::unique_lock<std::mutex>;
+
+
+    TaskGroup(Pool &threadPool) : pool(threadPool), pendingJobNum(0), cancelled(false) {}
+    ~TaskGroup() { join(); } // the exception is dropped if wait() has not been called.
+
+
+    template<typename Functor>
+    void run(Functor &&newJob) {
+        { Lock lock(mutex); ++pendingJobNum; }
+        pool.push([this, job = std::forward<Functor>(newJob)]() mutable {
+            try {
+                if (!cancelled) { job(); }
+            } catch (...) {
+                Lock lock(mutex);
+                if (!error) { error = std::current_exception(); }
+            }
+            finish(); // always reached, or wait() would block forever.
+        });
+    }
+
+    // block until all jobs in the group are finished or skipped.
+    void wait() {
+        join();
+        std::exception_ptr e;
+        { Lock lock(mutex); std::swap(e, error); }
+        if (e) { std::rethrow_exception(e); }
+    }
+
+    // jobs which have not started will be skipped. running jobs may poll isCancelled().
+    void cancel() { cancelled = true; }
+    bool isCancelled() const { return cancelled; }
+
+protected:
+    void join() {
+        Lock lock(mutex);
+        cv.wait(lock, [this]() { return (pendingJobNum == 0); });
+    }
+
+    void finish() {
+        Lock lock(mutex);
+        if (--pendingJobNum == 0) { cv.notify_all(); }
+    }
+
+
+    Pool &pool;
+    int pendingJobNum; // guarded by mutex.
+    std::atomic<bool> cancelled;
+    std::exception_ptr error; // guarded by mutex.
+    std::mutex mutex;
+    std::condition_variable cv;
+};
+
+
+// call body(i) for each i in [begin, end) in chunks of grain indices.
+template<typename Pool, typename Body>
+void parallelFor(Pool &pool, int begin, int end, int grain, Body body) {
+    grain = (std::max)(grain, 1);
+    TaskGroup<Pool> group(pool);
+    for (int b = begin; b < end; b += grain) {
+        int e = (std::min)(b + grain, end);
+        group.run([b, e, &body]() { for (int i = b; i < e; ++i) { body(i); } });
+    }
+    group.wait();
+}
+
+// reduce(...reduce(reduce(identity, map(begin)), map(begin + 1))..., map(end - 1)) in chunks of grain indices.
+// reduce should be associative since the chunks are reduced separately and then combined in order.
+template<typename Pool, typename T, typename Map, typename Reduce>
+T parallelReduce(Pool &pool, int begin, int end, int grain, const T &identity, Map map, Reduce reduce) {
+    grain = (std::max)(grain, 1);
+    int chunkNum = (end > begin) ? ((end - begin + grain - 1) / grain) : 0;
+    std::vector<T> partials(chunkNum, identity);
+    parallelFor(pool, 0, chunkNum, 1, [&](int c) {
+        T partial(identity);
+        for (int i = begin + c * grain, e = (std::min)(i + grain, end); i < e; ++i) { partial = reduce(partial, map(i)); }
+        partials[c] = partial;
+    });
+    T result(identity);
+    for (auto p = partials.begin(); p != partials.end(); ++p) { result = reduce(result, *p); }
+    return result;
+}
+}
+
+
+#endif // CK_CPPUTILIBS_THREAD_POOL_H
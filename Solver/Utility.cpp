@@ -1,5 +1,9 @@
 #include "Utility.h"
 
+#include <fstream>
+#include <sstream>
+#include <thread>
+
 #if _OS_MS_WINDOWS
 #include <Windows.h>
 #include <Psapi.h>
@@ -7,6 +11,15 @@
 // EXTEND[ck][9]: get memory usage on *nix.
 #endif // _OS_MS_WINDOWS
 
+#if _OS_GNU_LINUX
+#include <sched.h>
+#endif // _OS_GNU_LINUX
+
+#if _SIMD_AVX2 && _CC_MS_VC
+#include <intrin.h>
+#include <immintrin.h>
+#endif // _SIMD_AVX2
+
 
 using namespace std;
 
@@ -49,4 +62,158 @@ System::MemoryUsage System::peakMemoryUsage() {
     return mu;
 }
 
+vector<System::Cpu> System::availableCpus() {
+    vector<Cpu> cpus;
+
+    #if _OS_MS_WINDOWS
+    // EXTEND[ck][9]: support more than 64 logical processors (processor groups).
+    DWORD_PTR processMask, systemMask;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+        const int MaxCpuNum = sizeof(DWORD_PTR) * 8;
+        vector<int> packages(MaxCpuNum, 0);
+        vector<int> cores(MaxCpuNum);
+        for (int i = 0; i < MaxCpuNum; ++i) { cores[i] = i; }
+
+        DWORD len = 0;
+        GetLogicalProcessorInformation(nullptr, &len);
+        vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(len / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+        if (!info.empty() && GetLogicalProcessorInformation(info.data(), &len)) {
+            int package = 0;
+            for (auto i = info.begin(); i != info.end(); ++i) {
+                if ((i->Relationship != RelationProcessorCore) && (i->Relationship != RelationProcessorPackage)) { continue; }
+                int first = -1;
+                for (int c = 0; c < MaxCpuNum; ++c) {
+                    if (!(i->ProcessorMask & (static_cast<DWORD_PTR>(1) << c))) { continue; }
+                    if (first < 0) { first = c; }
+                    if (i->Relationship == RelationProcessorCore) { cores[c] = first; } else { packages[c] = package; }
+                }
+                if (i->Relationship == RelationProcessorPackage) { ++package; }
+            }
+        }
+
+        for (int c = 0; c < MaxCpuNum; ++c) {
+            if (processMask & (static_cast<DWORD_PTR>(1) << c)) { cpus.push_back({ c, packages[c], cores[c] }); }
+        }
+    }
+    #elif _OS_GNU_LINUX
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; ++c) {
+            if (!CPU_ISSET(c, &set)) { continue; }
+            string topology("/sys/devices/system/cpu/cpu" + to_string(c) + "/topology/");
+            Cpu cpu = { c, 0, c };
+
+            ifstream packageFile(topology + "physical_package_id");
+            packageFile >> cpu.package;
+
+            ifstream siblingFile(topology + "thread_siblings_list");
+            string siblings;
+            getline(siblingFile, siblings);
+            vector<int> siblingList(parseCpuList(siblings));
+            if (!siblingList.empty()) { cpu.core = *min_element(siblingList.begin(), siblingList.end()); }
+
+            cpus.push_back(cpu);
+        }
+    }
+    #endif // _OS_MS_WINDOWS
+
+    if (cpus.empty()) { // assume all processors are available and independent.
+        for (int c = 0; c < static_cast<int>(thread::hardware_concurrency()); ++c) { cpus.push_back({ c, 0, c }); }
+    }
+    return cpus;
+}
+
+double System::cpuQuota() {
+    #if _OS_GNU_LINUX
+    // find the cgroup of the process. it may be invisible inside a container, so the root is tried as well.
+    string v1Path, v2Path;
+    ifstream cgroupFile("/proc/self/cgroup");
+    for (string line; getline(cgroupFile, line);) { // e.g., "0::/user.slice" or "4:cpu,cpuacct:/docker/1a2b".
+        size_t first = line.find(':');
+        size_t second = line.find(':', first + 1);
+        if ((first == string::npos) || (second == string::npos)) { continue; }
+        string controllers(line.substr(first + 1, second - first - 1));
+        string path(line.substr(second + 1));
+        if (controllers.empty()) {
+            v2Path = path;
+        } else if ((',' + controllers + ',').find(",cpu,") != string::npos) {
+            v1Path = path;
+        }
+    }
+
+    // cgroup v2. the file contains "$MAX $PERIOD" where $MAX may be "max".
+    for (const string &dir : { "/sys/fs/cgroup" + v2Path, string("/sys/fs/cgroup") }) {
+        ifstream cpuMaxFile(dir + "/cpu.max");
+        string quota;
+        double period;
+        if (!(cpuMaxFile >> quota >> period)) { continue; }
+        if ((quota == "max") || (period <= 0)) { return 0; }
+        return atof(quota.c_str()) / period;
+    }
+
+    // cgroup v1. the quota is -1 if there is no limit.
+    for (const string &dir : { "/sys/fs/cgroup/cpu,cpuacct" + v1Path, "/sys/fs/cgroup/cpu" + v1Path,
+        string("/sys/fs/cgroup/cpu,cpuacct"), string("/sys/fs/cgroup/cpu") }) {
+        ifstream quotaFile(dir + "/cpu.cfs_quota_us");
+        ifstream periodFile(dir + "/cpu.cfs_period_us");
+        double quota, period;
+        if (!(quotaFile >> quota) || !(periodFile >> period)) { continue; }
+        if ((quota <= 0) || (period <= 0)) { return 0; }
+        return quota / period;
+    }
+    #endif // _OS_GNU_LINUX
+
+    // EXTEND[ck][9]: read the cpu rate limit of the job object on windows.
+    return 0;
+}
+
+bool System::bindThreadToCpu(int cpu) {
+    #if _OS_MS_WINDOWS
+    if ((cpu < 0) || (cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8))) { return false; }
+    return (SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu) != 0);
+    #elif _OS_GNU_LINUX
+    if ((cpu < 0) || (cpu >= CPU_SETSIZE)) { return false; }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return (sched_setaffinity(0, sizeof(set), &set) == 0); // 0 is the calling thread on linux.
+    #else
+    return false;
+    #endif // _OS_MS_WINDOWS
+}
+
+vector<int> System::parseCpuList(const string &str) {
+    vector<int> cpus;
+    istringstream iss(str);
+    for (string range; getline(iss, range, ',');) {
+        int first, last;
+        char dash;
+        istringstream rangeStream(range);
+        if (!(rangeStream >> first)) { continue; }
+        if (!(rangeStream >> dash >> last) || (dash != '-')) { last = first; }
+        for (int c = first; c <= last; ++c) { cpus.push_back(c); }
+    }
+    return cpus;
+}
+
+bool System::supportsAvx2() {
+    #if !_SIMD_AVX2
+    return false;
+    #elif _CC_MS_VC
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) { return false; }
+    __cpuid(info, 1);
+    static constexpr int OsXsave = (1 << 27);
+    static constexpr int Avx = (1 << 28);
+    if ((info[2] & (OsXsave | Avx)) != (OsXsave | Avx)) { return false; }
+    if ((_xgetbv(0) & 0x6) != 0x6) { return false; } // the os saves the xmm and ymm registers on context switches.
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+    #else
+    return __builtin_cpu_supports("avx2"); // also checks the os support.
+    #endif // _SIMD_AVX2
+}
+
 }
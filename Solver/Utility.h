@@ -24,6 +24,10 @@
 #include <ctime>
 #include <cmath>
 
+#if _CC_MS_VC
+#include <intrin.h>
+#endif // _CC_MS_VC
+
 
 #define UTILITY_NOT_IMPLEMENTED  throw "Not implemented yet!";
 
@@ -288,6 +292,13 @@ public:
     static int generateSeed() {
         return static_cast<int>(std::time(nullptr) + std::clock());
     }
+    // derive the seed of the i_th independent stream from the master seed by splitmix64.
+    static int deriveSeed(int seed, int i) {
+        unsigned long long z = static_cast<unsigned>(seed) + 0x9E3779B97F4A7C15ull * (static_cast<unsigned long long>(i) + 1);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return static_cast<int>(z ^ (z >> 31));
+    }
 
     Generator::result_type operator()() { return rgen(); }
 
@@ -715,6 +726,25 @@ public:
 
     static MemoryUsage memoryUsage();
     static MemoryUsage peakMemoryUsage();
+
+    struct Cpu {
+        int id; // index of the logical processor.
+        int package; // index of the physical socket.
+        int core; // the smallest id among the hyperthread siblings sharing the same physical core.
+    };
+
+    // logical processors which the process is allowed to run on.
+    static std::vector<Cpu> availableCpus();
+    // number of cpus granted by the cpu bandwidth limit of the cgroup (cpu.max or cfs quota).
+    // return 0 if there is no limit or it is not supported.
+    static double cpuQuota();
+    // pin the calling thread to the logical processor. return false if it fails or is not supported.
+    static bool bindThreadToCpu(int cpu);
+    // parse the list format of linux sysfs and cpusets, e.g., "0,2,4-7".
+    static std::vector<int> parseCpuList(const std::string &str);
+
+    // whether both the cpu and the os support avx2 instructions.
+    static bool supportsAvx2();
 };
 
 
@@ -746,6 +776,51 @@ public:
     }
 };
 
+
+class Bit {
+public:
+    using Word = unsigned long long;
+
+    static constexpr int WordBitNum = 64;
+    static constexpr int WordBitShift = 6;
+    static constexpr int WordBitMask = WordBitNum - 1;
+
+
+    // index of the most significant set bit. the word must not be 0.
+    static int highest(Word w) {
+        #if _CC_MS_VC && _WIN64
+        unsigned long i;
+        _BitScanReverse64(&i, w);
+        return static_cast<int>(i);
+        #elif _CC_MS_VC // the 64-bit intrinsics are not available on x86.
+        unsigned long i;
+        if (_BitScanReverse(&i, static_cast<unsigned long>(w >> 32))) { return static_cast<int>(i) + 32; }
+        _BitScanReverse(&i, static_cast<unsigned long>(w));
+        return static_cast<int>(i);
+        #else
+        return WordBitMask - __builtin_clzll(w);
+        #endif // _CC_MS_VC
+    }
+    // index of the least significant set bit. the word must not be 0.
+    static int lowest(Word w) {
+        #if _CC_MS_VC && _WIN64
+        unsigned long i;
+        _BitScanForward64(&i, w);
+        return static_cast<int>(i);
+        #elif _CC_MS_VC
+        unsigned long i;
+        if (_BitScanForward(&i, static_cast<unsigned long>(w))) { return static_cast<int>(i); }
+        _BitScanForward(&i, static_cast<unsigned long>(w >> 32));
+        return static_cast<int>(i) + 32;
+        #else
+        return __builtin_ctzll(w);
+        #endif // _CC_MS_VC
+    }
+
+    // mask of the bits in [0, i].
+    static Word lowMask(int i) { return (i >= WordBitMask) ? ~0ull : ((1ull << (i + 1)) - 1); }
+};
+
 }
 
 